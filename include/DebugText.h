@@ -0,0 +1,51 @@
+#ifndef DEBUGTEXT_H
+#define DEBUGTEXT_H
+
+#include <glad/glad.h>
+
+#include <string>
+#include <vector>
+
+#include "Mesh.h"
+#include "Shader.h"
+#include "VertexFormat.h"
+
+// on-screen debug text (frame times, draw-call counts, ...). the font is
+// an 8x8 bitmap baked into a small GL_RED atlas at construction, so there
+// is no font library and no file to load. addText() only appends quads to
+// a CPU list; flush() writes them all into one dynamic Mesh region and
+// issues ONE draw for everything, which keeps a full stats page far under
+// the 0.1 ms budget that lets us leave the overlay on in production.
+//
+// usage, after the frame's real rendering:
+//     debugText.addText(8, 8, statsLine);
+//     debugText.flush(window.getWidth(), window.getHeight());
+class DebugText {
+    public:
+        DebugText();
+        ~DebugText();
+
+        // queue a string at pixel position (x, y), origin top-left.
+        // glyphs are 8x8 px times `scale`; lowercase letters render with
+        // the uppercase glyphs (the baked font only carries ASCII 32..95)
+        void addText(float x, float y, const std::string &text, float scale = 2.0f);
+
+        // upload everything queued since the last flush and draw it in a
+        // single call. call after the scene is rendered so text sits on top
+        void flush(int screenWidth, int screenHeight);
+
+    private:
+        void bakeFontAtlas();
+
+        // pixel position + atlas uv, matching text.vert's two attributes
+        // (compile-time layout, so the mesh can't disagree with the struct)
+        using GlyphVertex = Vertex<Position2f, TexCoord2f>;
+
+        Shader shader;
+        MeshT<GlyphVertex> mesh; // dynamic, rewritten every flush
+        unsigned int fontTexture = 0;
+
+        std::vector<GlyphVertex> staging; // four vertices per queued glyph
+};
+
+#endif // DEBUGTEXT_H
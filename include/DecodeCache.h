@@ -0,0 +1,19 @@
+#ifndef DECODECACHE_H
+#define DECODECACHE_H
+
+// transparent raw-decode disk cache for PNG loads. images never change
+// between runs, yet every launch pays the full stbi inflate again; the
+// first decode of a file writes the raw pixel blob (plus its
+// width/height/channels) to a sidecar next to the source, and later
+// runs memory-map that blob and skip stb_image entirely -- decode cost
+// becomes page-in cost. the sidecar is validated against the source's
+// mtime and byte size, so editing an image just re-decodes and rewrites
+// it. a missing/stale/corrupt sidecar silently falls back to stbi.
+//
+// drop-in for the stbi pair: cachedDecode() in place of stbi_load(),
+// cachedDecodeFree() in place of stbi_image_free(). safe to call from
+// the decode worker threads.
+unsigned char* cachedDecode(const char* path, int* width, int* height, int* channels);
+void cachedDecodeFree(unsigned char* pixels);
+
+#endif // DECODECACHE_H
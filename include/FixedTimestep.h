@@ -0,0 +1,53 @@
+#ifndef FIXEDTIMESTEP_H
+#define FIXEDTIMESTEP_H
+
+#include <algorithm>
+#include <chrono>
+
+// decouples simulation from rendering: the sim always advances in fixed
+// ticks (deterministic, stable physics-style updates) no matter how long
+// the GPU takes to produce frames, and the renderer interpolates between
+// the last two ticks so motion stays smooth at any frame rate.
+//
+// per render frame:
+//     int ticks = timestep.beginFrame();
+//     for (int i = 0; i < ticks; i++) { previous = state; step(state, timestep.dt()); }
+//     render(mix(previous, state, timestep.alpha()));
+class FixedTimestep {
+    public:
+        explicit FixedTimestep(double tickHz = 60.0)
+            : tickSeconds(1.0 / tickHz), last(std::chrono::steady_clock::now()) {}
+
+        // how many fixed ticks the elapsed real time owes us. capped so a
+        // long GPU stall (or a debugger pause) can't snowball into a
+        // catch-up spiral where simulating makes the frame even longer
+        int beginFrame() {
+            auto now = std::chrono::steady_clock::now();
+            accumulator += std::chrono::duration<double>(now - last).count();
+            last = now;
+
+            int ticks = (int)(accumulator / tickSeconds);
+            ticks = std::min(ticks, MAX_TICKS_PER_FRAME);
+            accumulator -= ticks * tickSeconds;
+
+            // after a cap, drop the debt instead of carrying it forever
+            accumulator = std::min(accumulator, tickSeconds);
+            return ticks;
+        }
+
+        // fixed tick length in seconds
+        double dt() const { return tickSeconds; }
+
+        // how far into the next tick the frame lands, in [0, 1) -- the
+        // blend factor between the previous and current sim states
+        float alpha() const { return (float)(accumulator / tickSeconds); }
+
+    private:
+        static const int MAX_TICKS_PER_FRAME = 5;
+
+        double tickSeconds;
+        double accumulator = 0.0;
+        std::chrono::steady_clock::time_point last;
+};
+
+#endif // FIXEDTIMESTEP_H
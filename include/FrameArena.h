@@ -0,0 +1,88 @@
+#ifndef FRAMEARENA_H
+#define FRAMEARENA_H
+
+#include <cstddef>
+#include <vector>
+
+// linear allocator for data that only lives for one frame (cull lists,
+// staging buffers, text quads). allocate() is a pointer bump, reset() at
+// frame end frees EVERYTHING in one shot -- no per-vector malloc/free
+// churn, no heap fragmentation, and no allocator lock shared between
+// threads because every thread gets its own arena via threadLocal().
+//
+// anything allocated from an arena is invalid after reset(); per-frame
+// containers must not outlive the frame that built them.
+class FrameArena {
+    public:
+        explicit FrameArena(size_t blockBytes = 1 << 20); // 1 MiB blocks
+        ~FrameArena();
+
+        FrameArena(const FrameArena&) = delete;
+        FrameArena& operator=(const FrameArena&) = delete;
+
+        // bump-allocate `bytes` with the given alignment. falls over to
+        // the next block (growing the arena) when the current one is full
+        void* allocate(size_t bytes, size_t alignment = alignof(double));
+
+        // frame end: rewind to the start. blocks are kept, so after the
+        // first few frames this allocates nothing ever again
+        void reset();
+
+        // statistics: bytes handed out since the last reset, and the
+        // largest any frame ever got (the number worth putting on the
+        // overlay -- it is what the arena actually costs in memory)
+        size_t getFrameBytes() const { return frameBytes; }
+        size_t getHighWaterMark() const { return highWaterMark; }
+
+        // this thread's arena. each thread resets its own at frame end
+        static FrameArena& threadLocal();
+
+    private:
+        struct Block {
+            unsigned char* memory;
+            size_t size;
+        };
+
+        Block& blockWithRoom(size_t bytes);
+
+        std::vector<Block> blocks;
+        size_t blockBytes;
+        size_t currentBlock = 0;
+        size_t cursor = 0; // offset into blocks[currentBlock]
+
+        size_t frameBytes = 0;
+        size_t highWaterMark = 0;
+};
+
+// STL-compatible adapter so ordinary containers can live in the arena:
+//     FrameVector<float> scratch(count);   // this thread's arena
+// deallocate() is a no-op -- reset() is the only way memory comes back
+template <typename T>
+class ArenaAllocator {
+    public:
+        using value_type = T;
+
+        ArenaAllocator() : arena(&FrameArena::threadLocal()) {}
+        explicit ArenaAllocator(FrameArena& arena) : arena(&arena) {}
+
+        template <typename U>
+        ArenaAllocator(const ArenaAllocator<U>& other) : arena(other.arena) {}
+
+        T* allocate(size_t count) {
+            return static_cast<T*>(arena->allocate(count * sizeof(T), alignof(T)));
+        }
+
+        void deallocate(T*, size_t) {}
+
+        template <typename U>
+        bool operator==(const ArenaAllocator<U>& other) const { return arena == other.arena; }
+        template <typename U>
+        bool operator!=(const ArenaAllocator<U>& other) const { return arena != other.arena; }
+
+        FrameArena* arena;
+};
+
+template <typename T>
+using FrameVector = std::vector<T, ArenaAllocator<T>>;
+
+#endif // FRAMEARENA_H
@@ -0,0 +1,33 @@
+#ifndef FRUSTUM_H
+#define FRUSTUM_H
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+// the six planes of a view frustum, extracted from a view-projection
+// matrix (Gribb/Hartmann). planes are stored structure-of-arrays
+// (all x components together, then y, z, w) so cullSpheres can test
+// four bounding spheres per SSE iteration.
+class Frustum {
+    public:
+        Frustum() = default;
+        explicit Frustum(const glm::mat4 &viewProjection) { setFromMatrix(viewProjection); }
+
+        void setFromMatrix(const glm::mat4 &viewProjection);
+
+        // single sphere test: true when (at least partially) inside
+        bool testSphere(const glm::vec3 &center, float radius) const;
+
+        // batch test over SoA sphere arrays; writes 1 (visible) or 0 per
+        // sphere. SSE2 path does four spheres per iteration, with a
+        // scalar fallback on other targets
+        void cullSpheres(const float* centerX, const float* centerY, const float* centerZ,
+                         const float* radius, size_t count, unsigned char* visible) const;
+
+    private:
+        // plane i: planeX[i]*x + planeY[i]*y + planeZ[i]*z + planeW[i] >= 0 inside
+        float planeX[6] = {0}, planeY[6] = {0}, planeZ[6] = {0}, planeW[6] = {0};
+};
+
+#endif // FRUSTUM_H
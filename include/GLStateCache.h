@@ -0,0 +1,71 @@
+#ifndef GLSTATECACHE_H
+#define GLSTATECACHE_H
+
+// shadows the GL binding state the engine actually churns -- current
+// program, bound VAO, active unit + per-unit 2D texture bindings, clear
+// color -- and silently swallows calls that match what is already bound.
+// the driver does this too, but only after a full call dispatch; eliding
+// on our side is a compare and a branch. every engine call site goes
+// through here, so the shadow stays truthful; code that talks to GL
+// behind the cache's back must call invalidate() afterwards.
+//
+// deleting a GL object can implicitly unbind it AND its name gets
+// recycled by the next glGen*, so the owner classes report deletions via
+// the on*Deleted() hooks.
+//
+// render-thread only, like the rest of the GL-facing singletons.
+class GLStateCache {
+    public:
+        // the engine-wide cache (GL defaults assumed at first use, so
+        // create it after the context -- constructing any engine object
+        // does that anyway)
+        static GLStateCache& shared();
+
+        void useProgram(unsigned int program);
+        void bindVertexArray(unsigned int vao);
+
+        // texture binds: unit-explicit form for sampling setup, active-
+        // unit form for creation/upload code that binds wherever it is.
+        // bindTextureUnit only guarantees the unit -> id BINDING (when it
+        // already holds, the active-unit switch is skipped too); code
+        // that follows up with active-unit-dependent calls (glTexImage2D,
+        // glTexParameteri, ...) must use activeTexture + bindTexture2D
+        void bindTextureUnit(unsigned int unit, unsigned int id);
+        void activeTexture(unsigned int unit);
+        void bindTexture2D(unsigned int id);
+
+        void clearColor(float r, float g, float b, float a);
+
+        // deletion hooks (names get recycled; see header comment)
+        void onProgramDeleted(unsigned int program);
+        void onVertexArrayDeleted(unsigned int vao);
+        void onTextureDeleted(unsigned int id);
+
+        // forget everything shadowed; the next call of each kind issues
+        void invalidate();
+
+        // per-frame elided-vs-issued call counts for the profiler; reset
+        // after reading
+        unsigned int getIssuedCalls() const { return issuedCalls; }
+        unsigned int getElidedCalls() const { return elidedCalls; }
+        void resetCounters() { issuedCalls = 0; elidedCalls = 0; }
+
+    private:
+        GLStateCache();
+
+        static const unsigned int UNKNOWN = 0xFFFFFFFFu;
+        static const int MAX_UNITS = 32;
+
+        unsigned int currentProgram;
+        unsigned int currentVAO;
+        unsigned int currentUnit;
+        unsigned int boundTexture[MAX_UNITS];
+
+        bool clearColorKnown;
+        float currentClearColor[4];
+
+        unsigned int issuedCalls = 0;
+        unsigned int elidedCalls = 0;
+};
+
+#endif // GLSTATECACHE_H
@@ -0,0 +1,58 @@
+#ifndef JOBSYSTEM_H
+#define JOBSYSTEM_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// fixed pool of worker threads for CPU/disk work that does not need the
+// GL context (image decodes, file reads, ...). each worker owns a deque:
+// it pops its own work from the back and steals from the front of the
+// other workers' deques when it runs dry, so one slow queue cannot idle
+// the rest of the pool. final GL object creation stays on the context
+// thread -- jobs only prepare data.
+class JobSystem {
+    public:
+        // 0 -> one worker per hardware thread, minus one for the render
+        // thread (but always at least one)
+        explicit JobSystem(unsigned int threadCount = 0);
+        ~JobSystem();
+
+        // hand one unit of work to the pool
+        void submit(std::function<void()> job);
+
+        // block until every submitted job has finished
+        void waitIdle();
+
+        // the engine-wide pool (created on first use)
+        static JobSystem& shared();
+
+    private:
+        struct WorkerQueue {
+            std::deque<std::function<void()>> jobs;
+            std::mutex mutex;
+        };
+
+        // grab work: own queue from the back first, then steal from the
+        // front of everyone else's
+        bool tryGetJob(unsigned int workerIndex, std::function<void()>& job);
+        void workerLoop(unsigned int workerIndex);
+
+        std::vector<std::thread> workers;
+        std::vector<std::unique_ptr<WorkerQueue>> queues;
+        unsigned int submitCursor = 0; // round-robin target for submit()
+
+        std::mutex sleepMutex;
+        std::condition_variable workAvailable;
+        std::condition_variable allDone;
+        std::atomic<int> pendingJobs{0}; // queued + currently running
+        std::atomic<int> queuedJobs{0};  // sitting in a deque, not taken yet
+        std::atomic<bool> stopping{false};
+};
+
+#endif // JOBSYSTEM_H
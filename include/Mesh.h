@@ -3,21 +3,190 @@
 
 #include <glad/glad.h>
 #include <GLFW/glfw3.h>
+#include <cstddef>
 #include <vector>
 
-class Mesh { 
+#include <glm/glm.hpp>
+
+// describes how the bytes of one vertex are laid out in the VBO.
+// attributes are packed in the order they are add()ed, so e.g.
+//   VertexLayout().add(0, 3, GL_FLOAT)                    // position
+//                 .add(1, 4, GL_UNSIGNED_BYTE, true)      // color, 4 bytes instead of 12
+//                 .add(2, 2, GL_HALF_FLOAT)               // uv, 4 bytes instead of 8
+// gets a 20-byte vertex where the old hard-coded layout needed 32.
+class VertexLayout {
     public:
-        Mesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices);
+        struct Attribute {
+            unsigned int location;  // layout(location = N) in the shader
+            int components;         // 1..4
+            GLenum type;            // GL_FLOAT, GL_HALF_FLOAT, GL_UNSIGNED_BYTE, GL_INT_2_10_10_10_REV, ...
+            bool normalized;        // map integer range to [0,1] / [-1,1]
+            unsigned int offset;    // byte offset inside one vertex (computed)
+        };
+
+        VertexLayout& add(unsigned int location, int components, GLenum type, bool normalized = false);
+
+        unsigned int getStride() const { return stride; }
+        const std::vector<Attribute>& getAttributes() const { return attributes; }
+
+        // the 8-float interleaved layout (3 pos + 3 color + 2 uv) the
+        // engine used before layouts were configurable
+        static VertexLayout standard();
+
+    private:
+        std::vector<Attribute> attributes;
+        unsigned int stride = 0;
+};
+
+// per-instance payload for instanced draws (matches the layout the
+// instance buffer feeds into attribute locations 3..7 of the shader)
+struct InstanceData {
+    glm::mat4 transform;
+    glm::vec4 color;
+};
+
+class Mesh {
+    public:
+        Mesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices, GLenum drawMode = GL_TRIANGLES);
+
+        // same, but with `lodCount` detail levels: the simplification
+        // pass generates decreasing-detail index streams (all referencing
+        // the one vertex buffer) and packs them as ranges of a single
+        // EBO. triangles only; levels that stop shrinking are dropped,
+        // so tiny meshes just end up with one range
+        Mesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices,
+             int lodCount, GLenum drawMode);
+
+        // raw bytes + a layout describing them, for packed vertex formats
+        Mesh(const void* vertexData, size_t vertexDataSize, const VertexLayout& layout,
+             const std::vector<unsigned int>& indices, GLenum drawMode = GL_TRIANGLES);
+
+        // load a baked .glms mesh: the file holds header + layout + the
+        // vertex and index blobs already in final GPU format, so loading
+        // is mmap + two glBufferData calls straight from the mapping --
+        // no parsing and no intermediate vectors. a bad file logs and
+        // yields an empty mesh
+        static Mesh fromFile(const char* path);
+
+        // bake counterpart: write vertex/index blobs + layout as .glms.
+        // lodCount > 1 runs the simplification pass at bake time and
+        // stores the LOD ranges in the file, so runtime never simplifies
+        static bool writeFile(const char* path, const void* vertexData, size_t vertexDataSize,
+                              const VertexLayout& layout, const std::vector<unsigned int>& indices,
+                              GLenum drawMode = GL_TRIANGLES, int lodCount = 1);
+
+        // one decimation step of the bake pass: cluster positions on a
+        // gridResolution^3 grid, snap every triangle corner to its
+        // cell's representative vertex and drop collapsed triangles.
+        // returns a new index stream over the SAME vertices (empty when
+        // the layout has no plain 3-float position at location 0)
+        static std::vector<unsigned int> simplifyIndices(const void* vertexData, size_t vertexDataSize,
+                                                         const VertexLayout& layout,
+                                                         const std::vector<unsigned int>& indices,
+                                                         int gridResolution);
+
+        // dynamic mesh for geometry that is rewritten every frame. the VBO
+        // holds three regions of maxVertices each; writes go to the region
+        // the GPU is guaranteed (by fence) to be done reading, so the map
+        // never blocks on an in-flight draw. the index buffer stays static
+        Mesh(size_t maxVertices, const VertexLayout& layout,
+             const std::vector<unsigned int>& indices, GLenum drawMode = GL_TRIANGLES);
+
         ~Mesh();
 
+        // meshes own GL ids, so they move (the source is left empty) but
+        // never copy -- a copy would double-delete the buffers. this is
+        // what lets meshes live in contiguous vectors / pools
+        Mesh(Mesh&& other) noexcept;
+        Mesh& operator=(Mesh&& other) noexcept;
+        Mesh(const Mesh&) = delete;
+        Mesh& operator=(const Mesh&) = delete;
+
+        // per-frame write cycle for dynamic meshes:
+        //   void* dst = mesh.beginDynamicWrite();   // current region, mapped
+        //   ... fill up to maxVertices vertices ...
+        //   mesh.endDynamicWrite(vertexCount, indexCount);
+        void* beginDynamicWrite();
+        void endDynamicWrite(unsigned int verticesWritten, unsigned int indicesToDraw);
+
+        // which vertex the current region starts at (0 for static meshes);
+        // draws have to go through glDrawElementsBaseVertex with this
+        int getBaseVertex() const;
+
+        // attach a per-instance attribute buffer (mat4 transform at
+        // locations 3..6 + vec4 color at 7, divisor 1) so the same mesh
+        // can draw thousands of times from ONE call
+        void setupInstanceBuffer(size_t maxInstances);
+        bool hasInstanceBuffer() const { return instanceVBO != 0; }
+        size_t getMaxInstances() const { return maxInstances; }
+
+        // refill the instance buffer (orphan + copy; count capped at
+        // maxInstances). const like bind_VAO: touches GL state, not the mesh
+        void updateInstances(const InstanceData* data, size_t count) const;
+
+        // glDrawElementsInstanced over `count` instances. expects the VAO
+        // to be bound, like the renderer does for plain draws
+        void drawInstanced(size_t count) const;
+
+        // local-space bounding sphere, computed at construction from the
+        // position attribute (location 0, 3 floats). dynamic meshes and
+        // packed position formats have no bounds -> never culled
+        bool hasBounds() const { return boundsValid; }
+        const glm::vec3& getBoundsCenter() const { return boundsCenter; }
+        float getBoundsRadius() const { return boundsRadius; }
+
         void bind_VAO() const;
         void unbind_VAO() const;
 
         unsigned int getIndexCount() const;
+        unsigned int getVAO() const;
+        GLenum getDrawMode() const;
+
+        // LOD ranges inside the shared EBO (a mesh without a baked chain
+        // reports one level covering everything, so callers don't branch)
+        unsigned int getLodCount() const;
+        unsigned int getLodIndexCount(unsigned int lod) const;
+        unsigned int getLodFirstIndex(unsigned int lod) const;
 
 
     private:
+        // raw-pointer ctor used by fromFile so index data can come
+        // straight out of a memory-mapped file
+        Mesh(const void* vertexData, size_t vertexDataSize, const VertexLayout& layout,
+             const unsigned int* indexData, size_t indexCount, GLenum drawMode);
+
+        void setupBuffers(const void* vertexData, size_t vertexDataSize,
+                          const VertexLayout& layout, const unsigned int* indexData,
+                          size_t indexCount, GLenum usage);
+
+        void computeBounds(const void* vertexData, size_t vertexDataSize, const VertexLayout& layout);
+
         unsigned int VAO, VBO, EBO, indexcount;
+        GLenum drawmode;
+
+        // slices of the EBO at decreasing detail; empty = single level
+        struct LodRange {
+            unsigned int firstIndex;
+            unsigned int count;
+        };
+        std::vector<LodRange> lodRanges;
+
+        // instancing
+        unsigned int instanceVBO = 0;
+        size_t maxInstances = 0;
+
+        // culling bounds
+        bool boundsValid = false;
+        glm::vec3 boundsCenter = glm::vec3(0.0f);
+        float boundsRadius = 0.0f;
+
+        // dynamic (triple buffered) state
+        static const int DYNAMIC_REGIONS = 3;
+        bool dynamic = false;
+        size_t maxVertices = 0;
+        size_t vertexStride = 0;
+        int currentRegion = 0;
+        GLsync regionFence[DYNAMIC_REGIONS] = {nullptr, nullptr, nullptr};
 };
 
 #endif // MESH_H
\ No newline at end of file
@@ -0,0 +1,84 @@
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <glad/glad.h>
+
+#include <chrono>
+#include <deque>
+#include <map>
+#include <string>
+#include <vector>
+
+// per-stage frame timing. CPU stages are scoped RAII timers, GPU stages
+// are GL_TIMESTAMP query pairs kept in a ring and harvested a frame (or
+// two) late so reading them never stalls the pipeline.
+//
+// usage in the render loop:
+//     profiler.beginFrame();
+//     { ProfileScope s(profiler, "flush"); renderer.flush(); }
+//     profiler.beginGpu("draw"); renderer.flush(); profiler.endGpu();
+//     profiler.endFrame();
+class Profiler {
+    public:
+        ~Profiler();
+
+        void beginFrame();
+        void endFrame(); // harvests finished GPU queries + records frame time
+
+        // GPU stage bracket (GPU stages show up with a " (gpu)" suffix)
+        void beginGpu(const std::string &name);
+        void endGpu();
+
+        // one sample for a stage, in milliseconds (ProfileScope calls this)
+        void recordSample(const std::string &name, float milliseconds);
+
+        // newest sample for a stage in milliseconds (0 before the first
+        // sample lands) -- this is what the on-screen overlay reads
+        float lastMs(const std::string &name) const;
+
+        // print avg / p50 / p95 / p99 per stage to stdout
+        void printSummary() const;
+
+        // same numbers as CSV: stage,samples,avg_ms,p50_ms,p95_ms,p99_ms
+        void writeCSV(const std::string &path) const;
+
+    private:
+        struct Stage {
+            std::vector<float> samples; // ring, newest overwrites oldest
+            size_t cursor = 0;
+        };
+
+        struct GpuQuery {
+            std::string name;
+            unsigned int beginQuery = 0;
+            unsigned int endQuery = 0;
+        };
+
+        unsigned int allocQuery();
+
+        std::map<std::string, Stage> stages;
+        std::deque<GpuQuery> inFlight;       // oldest first
+        std::vector<unsigned int> queryPool; // recycled query ids
+        GpuQuery pending;                    // between beginGpu and endGpu
+        std::chrono::steady_clock::time_point frameStart;
+        bool frameOpen = false;
+};
+
+// times one CPU stage for as long as it is alive
+class ProfileScope {
+    public:
+        ProfileScope(Profiler &profiler, const std::string &name)
+            : profiler(profiler), name(name), start(std::chrono::steady_clock::now()) {}
+
+        ~ProfileScope() {
+            auto elapsed = std::chrono::steady_clock::now() - start;
+            profiler.recordSample(name, std::chrono::duration<float, std::milli>(elapsed).count());
+        }
+
+    private:
+        Profiler &profiler;
+        std::string name;
+        std::chrono::steady_clock::time_point start;
+};
+
+#endif // PROFILER_H
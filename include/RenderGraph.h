@@ -0,0 +1,105 @@
+#ifndef RENDERGRAPH_H
+#define RENDERGRAPH_H
+
+#include <glad/glad.h>
+
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+
+// declarative frame scheduler: passes say which attachments they read
+// and write, and the graph works out the rest each frame --
+//   * passes whose outputs nothing consumes are culled outright,
+//   * execution order is chosen to respect data dependencies while
+//     grouping passes that render into the same target, so FBO rebinds
+//     are minimized without anyone hand-ordering anything,
+//   * transient attachments with non-overlapping lifetimes and matching
+//     size/format alias the same GL memory.
+// adding a pass therefore never silently adds a stall or a rebind the
+// declared dependencies don't require.
+//
+// attachments are created once; the pass list is rebuilt per frame:
+//     auto shadow = graph.createAttachment("shadow", 1024, 1024, GL_RGBA8);
+//     ...
+//     graph.reset();
+//     graph.addPass("shadow", {}, {shadow}, [&] { ... });
+//     graph.addPass("scene", {shadow}, {RenderGraph::BACKBUFFER}, [&] { ... });
+//     graph.execute();
+class RenderGraph {
+    public:
+        using ResourceId = int;
+        static const ResourceId BACKBUFFER = -1; // the default framebuffer
+
+        ~RenderGraph();
+
+        // a transient render target. GL_DEPTH24_STENCIL8 becomes a depth
+        // attachment (renderbuffer, not samplable); everything else is a
+        // color texture that later passes can sample
+        ResourceId createAttachment(const std::string& name, int width, int height, GLenum format);
+
+        // declare one pass for this frame. reads order passes (a pass
+        // runs after whatever writes its reads); writes pick the FBO
+        void addPass(const std::string& name,
+                     std::vector<ResourceId> reads,
+                     std::vector<ResourceId> writes,
+                     std::function<void()> execute);
+
+        // forget this frame's passes (attachments stay)
+        void reset();
+
+        // compile (cull, order, alias) and run everything
+        void execute();
+
+        // GL texture behind an attachment, for sampling in a later pass.
+        // only valid between compile and the end of the frame, since
+        // aliasing can hand the memory to someone else afterwards
+        unsigned int getAttachmentTexture(ResourceId id) const;
+
+        // overlay fodder
+        unsigned int getLastFboBinds() const { return lastFboBinds; }
+        unsigned int getLastCulledPasses() const { return lastCulledPasses; }
+
+    private:
+        struct Attachment {
+            std::string name;
+            int width = 0, height = 0;
+            GLenum format = 0;
+            int physical = -1;      // index into physicals, set by compile
+            int firstUse = -1, lastUse = -1;
+        };
+
+        struct Pass {
+            std::string name;
+            std::vector<ResourceId> reads;
+            std::vector<ResourceId> writes;
+            std::function<void()> run;
+            bool live = false;
+        };
+
+        // one actual GL object, shared by aliasing attachments
+        struct Physical {
+            unsigned int id = 0; // texture, or renderbuffer for depth
+            int width = 0, height = 0;
+            GLenum format = 0;
+            bool isDepth = false;
+            int availableAfter = -1; // schedule index its current user ends at
+        };
+
+        void cullPasses();
+        void orderPasses();
+        void aliasAttachments();
+        unsigned int fboForWrites(const std::vector<ResourceId>& writes);
+
+        std::vector<Attachment> attachments;
+        std::vector<Pass> passes;
+        std::vector<size_t> schedule; // indices into passes, execution order
+
+        std::vector<Physical> physicals;
+        std::map<std::vector<int>, unsigned int> fboCache; // physical ids -> FBO
+
+        unsigned int lastFboBinds = 0;
+        unsigned int lastCulledPasses = 0;
+};
+
+#endif // RENDERGRAPH_H
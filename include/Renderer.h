@@ -0,0 +1,132 @@
+#ifndef RENDERER_H
+#define RENDERER_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Frustum.h"
+#include "Mesh.h"
+#include "Shader.h"
+#include "Texture.h"
+
+// one queued draw -> everything needed to render one mesh once
+struct RenderCommand {
+    const Mesh* mesh;
+    Shader* shader;
+    std::vector<const Texture*> textures;
+    glm::mat4 transform;
+};
+
+class Renderer {
+    public:
+        Renderer();
+        ~Renderer();
+
+        // meshes call these from their destructor / move constructor.
+        // renderers keep per-mesh state keyed by pointer (occlusion
+        // queries, LOD hysteresis), and the resource pool swap-removes,
+        // so a new mesh can land at exactly the address a dead one
+        // vacated -- same reason GLStateCache has onTextureDeleted
+        static void onMeshDestroyed(const Mesh* mesh);
+        static void onMeshMoved(const Mesh* from, const Mesh* to);
+
+        // queue a draw for this frame (nothing touches GL until flush())
+        void submit(const Mesh& mesh, Shader& shader,
+                    const std::vector<const Texture*>& textures,
+                    const glm::mat4& transform);
+
+        // cull everything outside this frustum during flush(). pass the
+        // same view-projection matrix the shaders use
+        void setFrustum(const glm::mat4 &viewProjection);
+        void clearFrustum();
+
+        // where the camera sits in world space; LOD selection measures
+        // distance from here (defaults to the origin)
+        void setCameraPosition(const glm::vec3 &position);
+
+        // opt-in: build the frame on the job system. workers cull, encode
+        // sort keys and sort fixed-size per-thread command buffers in
+        // parallel; flush() then merges the pre-sorted shards and replays
+        // the stream on the context thread (GL calls never leave it).
+        // kicks in above a command-count threshold, order matches the
+        // single-threaded sort exactly
+        void setParallelRecordingEnabled(bool enabled);
+
+        // opt-in: wrap draws in GL_ANY_SAMPLES_PASSED queries and skip
+        // meshes that were fully occluded last frame (re-tested
+        // periodically). only worth it for large occludees
+        void setOcclusionCullingEnabled(bool enabled);
+
+        // sort the queue (shader -> texture -> VAO) and draw it with the
+        // fewest possible bind calls, then clear it for the next frame
+        void flush();
+
+        // counts from the most recent flush() (the stats overlay reads
+        // these): GL draw calls issued, and commands submitted before
+        // culling/batching collapsed them
+        unsigned int getLastDrawCallCount() const { return lastDrawCalls; }
+        unsigned int getLastCommandCount() const { return lastCommands; }
+
+    private:
+        // drops commands whose bounding spheres are fully outside the
+        // frustum (SoA + SIMD batch test)
+        void cullCommands();
+
+        // one encoded draw: the sort key plus the index of its command.
+        // workers fill shards of these; keys make the merge and the
+        // redundant-bind checks plain integer compares
+        struct EncodedDraw {
+            uint64_t key;
+            uint32_t index;
+        };
+
+        // parallel frame build: shard the queue across workers, each one
+        // culls + encodes + sorts its own buffer, then merge in order
+        void recordParallel();
+        void recordShard(size_t shard, size_t begin, size_t end);
+
+        // picks an index-buffer detail level from projected size (bounds
+        // radius over camera distance), with hysteresis against popping
+        unsigned int selectLod(const RenderCommand& cmd);
+
+        // per-instance halves of the static mesh hooks above
+        void forgetMesh(const Mesh* mesh);
+        void migrateMesh(const Mesh* from, const Mesh* to);
+
+        // every live renderer, so ~Mesh can reach them all. render-thread
+        // only, like everything else in this class
+        static std::vector<Renderer*> liveRenderers;
+
+        struct OcclusionState {
+            unsigned int query = 0;
+            bool queryInFlight = false;
+            bool occluded = false;
+            unsigned int framesSkipped = 0;
+        };
+
+        std::vector<RenderCommand> commands;
+        std::vector<InstanceData> instanceStaging; // reused across frames
+
+        bool frustumEnabled = false;
+        Frustum frustum;
+
+        bool occlusionEnabled = false;
+        std::unordered_map<const Mesh*, OcclusionState> occlusionStates;
+
+        glm::vec3 cameraPosition = glm::vec3(0.0f);
+        std::unordered_map<const Mesh*, unsigned int> lodStates; // last chosen level
+
+        bool parallelEnabled = false;
+        std::vector<std::vector<EncodedDraw>> shardBuffers; // reused across frames
+        std::vector<unsigned char> parallelVisible;
+        std::vector<RenderCommand> mergeScratch;
+
+        unsigned int lastDrawCalls = 0;
+        unsigned int lastCommands = 0;
+};
+
+#endif // RENDERER_H
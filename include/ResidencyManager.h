@@ -0,0 +1,56 @@
+#ifndef RESIDENCYMANAGER_H
+#define RESIDENCYMANAGER_H
+
+#include <cstddef>
+#include <unordered_map>
+
+class Texture;
+
+// keeps the sum of resident texture memory under a VRAM budget so the
+// driver never starts paging mid-frame. every Texture registers here;
+// bind() stamps its last-used frame, and endFrame() demotes the
+// least-recently-used textures (down to a small resident tail, see
+// Texture::demote) whenever the budget is exceeded. using or
+// prefetching a demoted texture promotes it back to full resolution.
+//
+// render-thread only, like the GL objects it manages. the budget covers
+// managed Textures -- meshes, PBOs and the font atlas are not counted.
+class ResidencyManager {
+    public:
+        static ResidencyManager& shared();
+
+        // 0 = unlimited (the default: nothing is ever demoted)
+        void setBudget(size_t bytes) { budget = bytes; }
+        size_t getBudget() const { return budget; }
+        size_t getResidentBytes() const { return residentBytes; }
+
+        // once per frame, after rendering: advances the LRU clock, polls
+        // textures with an in-flight promotion, then evicts over-budget
+        void endFrame();
+
+        // culling hint: this texture was submitted but culled away, so it
+        // is probably visible soon -- keep it resident and start
+        // re-promoting it now instead of when it first hits the screen
+        void prefetch(const Texture* texture);
+
+        // -- called by Texture itself --
+        void add(Texture* texture);
+        void remove(const Texture* texture);
+        void onMoved(const Texture* from, Texture* to);
+        void updateBytes(const Texture* texture, size_t bytes);
+        void touch(const Texture* texture); // Texture::bind()
+
+    private:
+        struct Entry {
+            Texture* texture = nullptr;
+            size_t bytes = 0;
+            unsigned long lastUsed = 0;
+        };
+
+        std::unordered_map<const Texture*, Entry> entries;
+        size_t budget = 0;
+        size_t residentBytes = 0;
+        unsigned long frameClock = 0;
+};
+
+#endif // RESIDENCYMANAGER_H
@@ -0,0 +1,103 @@
+#ifndef RESOURCEPOOL_H
+#define RESOURCEPOOL_H
+
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// generation-checked pool for movable resources (Mesh, Texture, Shader).
+// the objects live in ONE dense array -- begin()/end() walk them with no
+// pointer chasing, which is what per-frame batching wants -- and callers
+// hold small Handles instead of pointers. removing a resource bumps its
+// slot's generation, so every stale handle turns into a nullptr lookup
+// instead of a dangling pointer. removal keeps the array dense by moving
+// the last element into the hole (hence: T must be movable).
+//
+//     ResourcePool<Mesh> meshes;
+//     auto handle = meshes.add(Mesh(vertices, indices));
+//     if (Mesh* mesh = meshes.get(handle)) { ... }
+//     meshes.remove(handle);
+template <typename T>
+class ResourcePool {
+    public:
+        struct Handle {
+            uint32_t slot = 0;
+            uint32_t generation = 0; // 0 never matches -> default Handle is null
+
+            bool operator==(const Handle& other) const {
+                return slot == other.slot && generation == other.generation;
+            }
+        };
+
+        // take ownership of the resource and hand back its ticket
+        Handle add(T&& resource) {
+            uint32_t slot;
+            if (!freeSlots.empty()) {
+                slot = freeSlots.back();
+                freeSlots.pop_back();
+            } else {
+                slot = (uint32_t)slots.size();
+                slots.push_back({0, 1});
+            }
+
+            slots[slot].denseIndex = (uint32_t)items.size();
+            items.push_back(std::move(resource));
+            denseToSlot.push_back(slot);
+            return {slot, slots[slot].generation};
+        }
+
+        // nullptr when the handle is stale (resource removed) or null
+        T* get(Handle handle) {
+            if (handle.slot >= slots.size() || slots[handle.slot].generation != handle.generation) {
+                return nullptr;
+            }
+            return &items[slots[handle.slot].denseIndex];
+        }
+
+        const T* get(Handle handle) const {
+            return const_cast<ResourcePool*>(this)->get(handle);
+        }
+
+        // destroy the resource; every copy of the handle goes stale
+        void remove(Handle handle) {
+            if (get(handle) == nullptr) {
+                return;
+            }
+
+            uint32_t dense = slots[handle.slot].denseIndex;
+            uint32_t last = (uint32_t)items.size() - 1;
+            if (dense != last) {
+                // keep the array dense: the last element fills the hole,
+                // and its slot is patched to the new position
+                items[dense] = std::move(items[last]);
+                denseToSlot[dense] = denseToSlot[last];
+                slots[denseToSlot[dense]].denseIndex = dense;
+            }
+            items.pop_back();
+            denseToSlot.pop_back();
+
+            slots[handle.slot].generation++;
+            freeSlots.push_back(handle.slot);
+        }
+
+        size_t size() const { return items.size(); }
+
+        // dense iteration, in no particular order
+        T* begin() { return items.data(); }
+        T* end() { return items.data() + items.size(); }
+        const T* begin() const { return items.data(); }
+        const T* end() const { return items.data() + items.size(); }
+
+    private:
+        struct Slot {
+            uint32_t denseIndex;
+            uint32_t generation;
+        };
+
+        std::vector<Slot> slots;          // indexed by Handle::slot
+        std::vector<T> items;             // the resources, dense
+        std::vector<uint32_t> denseToSlot; // parallel to items
+        std::vector<uint32_t> freeSlots;
+};
+
+#endif // RESOURCEPOOL_H
@@ -0,0 +1,42 @@
+#ifndef SCENE_H
+#define SCENE_H
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+// transform hierarchy with lazy world matrices. nodes live in contiguous
+// arrays and refer to their parent by index; a node is always added
+// AFTER its parent, so one forward pass over the arrays sees parents
+// before children and can propagate dirtiness without recursion.
+// only subtrees that actually moved pay the matrix multiply -- a static
+// node's cached world matrix is handed out untouched.
+class Scene {
+    public:
+        static const int NO_PARENT = -1;
+
+        // add a node under `parent` (NO_PARENT for a root); returns its index
+        int addNode(int parent = NO_PARENT);
+
+        // replace a node's local transform and mark its subtree stale
+        void setLocalTransform(int node, const glm::mat4 &transform);
+
+        // cached world matrix (recomputes pending subtrees first)
+        const glm::mat4& getWorldTransform(int node);
+
+        // recompute every stale world matrix in one pass; called lazily
+        // by getWorldTransform, but can be run explicitly per frame
+        void update();
+
+        int getNodeCount() const { return (int)parents.size(); }
+
+    private:
+        std::vector<int> parents;
+        std::vector<glm::mat4> local;
+        std::vector<glm::mat4> world;
+        std::vector<char> dirty;      // per node: local changed since update
+        std::vector<char> recomputed; // scratch for one update() pass
+        bool anyDirty = false;
+};
+
+#endif // SCENE_H
@@ -4,9 +4,13 @@
 #include <glad/glad.h>
 
 #include <string>
+#include <filesystem>
 #include <fstream>
 #include <sstream>
 #include <iostream>
+#include <unordered_map>
+
+#include <glm/glm.hpp>
 
 
 class Shader{
@@ -17,13 +21,67 @@ class Shader{
         // constructor
         Shader(const char* vertexPath, const char* fragmentPath);
 
+        // deletes the program (and any reload still compiling)
+        ~Shader();
+
+        // movable, never copyable, like Mesh and Texture
+        Shader(Shader&& other) noexcept;
+        Shader& operator=(Shader&& other) noexcept;
+        Shader(const Shader&) = delete;
+        Shader& operator=(const Shader&) = delete;
+
         // initialize program
         void initialize();
 
-        // utility functions
+        // utility functions (all go through the cached locations, no
+        // glGetUniformLocation round-trip per call)
         void setBool(const std::string &name, bool value) const;
         void setInt(const std::string &name, int value) const;
         void setFloat(const std::string &name, float value) const;
+        void setVec2(const std::string &name, const glm::vec2 &value) const;
+        void setVec3(const std::string &name, const glm::vec3 &value) const;
+        void setMat4(const std::string &name, const glm::mat4 &value) const;
+
+        // cached lookup (falls back to glGetUniformLocation once for names
+        // the introspection pass did not see, then remembers the answer)
+        GLint getUniformLocation(const std::string &name) const;
+
+        // attach a named uniform block to a binding point (call once after
+        // construction; quietly ignores blocks this program doesn't use)
+        void bindUniformBlock(const std::string &blockName, unsigned int bindingPoint) const;
+
+        // hot reload: call periodically (a few times a second is plenty).
+        // when a source file's mtime changes, a replacement program starts
+        // compiling -- in the driver's background threads where
+        // GL_KHR_parallel_shader_compile is available -- while the old
+        // program keeps rendering; once the new link completes it is
+        // swapped in atomically (or dropped, on compile errors)
+        void checkForReload();
+
+    private:
+        // ask the driver for every active uniform once, right after linking
+        void cacheUniformLocations();
+
+        // binary program cache (skips recompiling the GLSL on later runs)
+        std::string binaryCachePath(const std::string &vertexCode, const std::string &fragmentCode) const;
+        bool loadFromBinaryCache(const std::string &path);
+        void storeInBinaryCache(const std::string &path) const;
+
+        // finish a pending reload if its link is done; never blocks
+        void pollPendingReload();
+        void startReload();
+
+        // name -> location, filled by cacheUniformLocations()
+        mutable std::unordered_map<std::string, GLint> uniformLocations;
+
+        // uniform block bindings to re-apply after a reload swap
+        mutable std::unordered_map<std::string, unsigned int> blockBindings;
+
+        // hot reload state
+        std::string vertexPath, fragmentPath;
+        std::filesystem::file_time_type vertexTime, fragmentTime;
+        unsigned int pendingProgram = 0;
+        unsigned int pendingVertexShader = 0, pendingFragmentShader = 0;
 
 };
 
@@ -0,0 +1,23 @@
+#ifndef SIMDMATH_H
+#define SIMDMATH_H
+
+#include <cstddef>
+
+#include <glm/glm.hpp>
+
+// batch transform kernels for CPU-side vertex processing. the streams
+// are structure-of-arrays (all x together, then y, then z) so the SSE2
+// path -- same #ifdef __SSE2__ arrangement as Frustum::cullSpheres, with
+// a scalar fallback elsewhere -- can run four lanes per iteration with
+// plain aligned-agnostic loads. transforms are in place.
+
+// points: (x, y, z, 1) * matrix, i.e. translation applies
+void transformPoints(const glm::mat4& matrix,
+                     float* xs, float* ys, float* zs, size_t count);
+
+// directions: (x, y, z, 0) * matrix -- no translation. for normals under
+// non-uniform scale, pass the inverse-transpose and renormalize after
+void transformDirections(const glm::mat4& matrix,
+                         float* xs, float* ys, float* zs, size_t count);
+
+#endif // SIMDMATH_H
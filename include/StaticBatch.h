@@ -0,0 +1,92 @@
+#ifndef STATICBATCH_H
+#define STATICBATCH_H
+
+#include <glad/glad.h>
+
+#include <vector>
+
+#include <glm/glm.hpp>
+
+#include "Frustum.h"
+#include "Mesh.h"
+
+// all static world geometry merged into ONE VBO/EBO pair and drawn with
+// a single glMultiDrawElementsIndirect call (resolved at runtime -- it
+// is GL 4.3 / ARB_multi_draw_indirect and our loader stops at 3.3; on
+// drivers without it the same command list is replayed as a
+// glDrawElementsBaseVertex loop, which still costs zero rebinds).
+// transforms are baked into the vertices at build() time, which is what
+// makes the geometry "static".
+//
+// usage at level load:
+//     batch.add(vertices, indices, transform);  // repeat per mesh
+//     batch.build();
+// and per frame:
+//     batch.cull(frustum);   // optional: rewrites the command list
+//     batch.draw();          // one call for the whole static world
+class StaticBatch {
+    public:
+        StaticBatch() = default;
+        ~StaticBatch();
+
+        // same ownership rules as Mesh: movable, never copyable
+        StaticBatch(StaticBatch&& other) noexcept;
+        StaticBatch& operator=(StaticBatch&& other) noexcept;
+        StaticBatch(const StaticBatch&) = delete;
+        StaticBatch& operator=(const StaticBatch&) = delete;
+
+        // append one mesh (standard 3 pos + 3 color + 2 uv layout) with
+        // its world transform baked into the positions. build() must not
+        // have run yet
+        void add(const std::vector<float>& vertices,
+                 const std::vector<unsigned int>& indices,
+                 const glm::mat4& transform);
+
+        // upload the merged buffers + the indirect command list. after
+        // this, add() is an error and the CPU-side vertex copy is freed
+        void build();
+
+        // drop commands whose world-space bounding sphere is outside the
+        // frustum: visible commands are compacted to the front of the
+        // indirect buffer and only the count changes -- the draw loop is
+        // never touched
+        void cull(const Frustum& frustum);
+        void resetCull(); // everything visible again
+
+        // expects the caller's shader to be bound (with an identity
+        // "transform", since positions are already in world space)
+        void draw() const;
+
+        size_t getMeshCount() const { return commands.size(); }
+        unsigned int getActiveCount() const { return activeCount; }
+
+    private:
+        // mirrors the GL DrawElementsIndirectCommand layout exactly --
+        // the buffer is uploaded as-is
+        struct DrawCommand {
+            unsigned int count;
+            unsigned int instanceCount;
+            unsigned int firstIndex;
+            unsigned int baseVertex;
+            unsigned int baseInstance;
+        };
+
+        unsigned int VAO = 0, VBO = 0, EBO = 0, indirectBuffer = 0;
+        bool built = false;
+
+        // builder-phase staging (cleared by build())
+        std::vector<float> mergedVertices;
+        std::vector<unsigned int> mergedIndices;
+
+        std::vector<DrawCommand> commands;       // full list, build order
+        std::vector<DrawCommand> activeCommands; // post-cull, compacted
+
+        // world-space bounding spheres per command, SoA so cull() can
+        // hand them straight to Frustum::cullSpheres (SIMD batch test)
+        std::vector<float> centerX, centerY, centerZ, radius;
+        std::vector<unsigned char> visible; // scratch, parallel to commands
+
+        unsigned int activeCount = 0;
+};
+
+#endif // STATICBATCH_H
@@ -4,21 +4,84 @@
 #include <glad/glad.h>
 #include <stb_image/stb_image.h>
 
+#include <atomic>
+#include <memory>
+#include <string>
+
 class Texture {
     public:
+        // blocking load (decode + upload right here, like always)
         Texture(const char* filepath, unsigned int textureUnit);
+
+        // streamed load: the decode runs as a job on the shared worker
+        // pool, upload goes through a PBO ring on the next update() call.
+        // until then the texture is a 1x1 grey placeholder so draws never
+        // wait on I/O
+        Texture(const char* filepath, unsigned int textureUnit, bool streamed);
+
         ~Texture();
 
+        // movable, never copyable (same reasoning as Mesh: the GL id has
+        // exactly one owner). an in-flight streamed decode moves along
+        // with the texture -- the job only touches the shared DecodeResult
+        Texture(Texture&& other) noexcept;
+        Texture& operator=(Texture&& other) noexcept;
+        Texture(const Texture&) = delete;
+        Texture& operator=(const Texture&) = delete;
+
         void load_image(const char* filepath);
 
+        // render thread, once per frame: picks up a finished decode and
+        // DMA-uploads it through the PBO ring. cheap no-op otherwise
+        void update();
+
+        // true once the real image is on the GPU (placeholder gone)
+        bool isResident() const;
+
+        // residency manager hooks. demote() throws the big mips away and
+        // keeps a small tail (64px for .gltx containers, a 1x1 grey for
+        // PNG-loaded textures); promote() brings the full image back --
+        // synchronously for containers (mmap + upload, no decode), via a
+        // background decode job for PNGs
+        void demote();
+        void promote();
+        bool isDemoted() const { return demoted; }
+        size_t getGpuBytes() const { return gpuBytes; }
 
         void bind() const;
         void unbind() const;
 
+        unsigned int getID() const { return ID; }
+        unsigned int getUnit() const { return unit; }
+
     private:
+        void createPlaceholder();
+        void startStreamedDecode();
+
+        // VRAM estimate for an RGBA image of this size plus its mip chain
+        static size_t estimateBytes(int width, int height);
+
         int width, height, nrChannels;
-        const char* filepath;
+        std::string path;
         unsigned int ID, unit;
+
+        // result of one background decode. shared between the job and the
+        // texture so whichever lets go last cleans up the pixels -- the
+        // texture can even be destroyed while the job still runs
+        struct DecodeResult {
+            std::atomic<bool> done{false};
+            unsigned char* pixels = nullptr;
+            int width = 0, height = 0, nrChannels = 0;
+            ~DecodeResult();
+        };
+
+        bool streaming = false;
+        bool resident = true;
+        std::shared_ptr<DecodeResult> decode;
+
+        // residency state (see ResidencyManager)
+        bool demoted = false;
+        size_t gpuBytes = 0;
 };
 
-#endif // TEXTURE_H
\ No newline at end of file
+#endif // TEXTURE_H
@@ -0,0 +1,59 @@
+#ifndef TEXTUREATLAS_H
+#define TEXTUREATLAS_H
+
+#include <glad/glad.h>
+#include <stb_image/stb_image.h>
+
+#include <string>
+#include <vector>
+
+// where one packed image ended up inside the atlas, in [0,1] uv space
+struct AtlasRegion {
+    float u0 = 0.0f, v0 = 0.0f; // bottom-left
+    float u1 = 0.0f, v1 = 0.0f; // top-right
+    bool valid = false;
+};
+
+// packs many small images into ONE texture so a whole sprite pass can
+// render with a single bind() and a single draw call. packing is shelf
+// based: images go left to right on the current shelf, and a new shelf
+// opens below when the current one is full.
+class TextureAtlas {
+    public:
+        TextureAtlas(int width, int height, unsigned int textureUnit);
+        ~TextureAtlas();
+
+        // decode one image and pack it; returns its uv rect (valid=false
+        // when the file failed to load or the atlas is full)
+        AtlasRegion addImage(const char* filepath);
+
+        // upload the packed pixels to the GL texture. call once after the
+        // last addImage() (adding more later and re-building also works)
+        void build();
+
+        void bind() const;
+        void unbind() const;
+
+        unsigned int getID() const { return ID; }
+        unsigned int getUnit() const { return unit; }
+
+        // map a [0,1] uv into a region's sub-rect -> what vertex uvs need
+        // to become when a mesh switches from its own texture to the atlas
+        static void remapUV(const AtlasRegion &region, float &u, float &v);
+
+        // same remap over a whole standard-layout vertex array
+        // (8 floats per vertex, uv at offset 6 -> see VertexLayout::standard)
+        static void remapUVs(std::vector<float> &vertices, const AtlasRegion &region);
+
+    private:
+        int width, height;
+        unsigned int ID, unit;
+
+        // shelf packing cursor
+        int shelfX = 0, shelfY = 0, shelfHeight = 0;
+
+        std::vector<unsigned char> pixels; // RGBA8, CPU side
+        bool dirty = false;
+};
+
+#endif // TEXTUREATLAS_H
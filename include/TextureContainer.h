@@ -0,0 +1,39 @@
+#ifndef TEXTURECONTAINER_H
+#define TEXTURECONTAINER_H
+
+#include <glad/glad.h>
+
+// .gltx: the engine's baked texture container. the whole mip chain is
+// precomputed at bake time (optionally BC1 block-compressed), so the
+// runtime loader just memory-maps the file and hands each level straight
+// to glTexImage2D / glCompressedTexImage2D -- no PNG decode and no
+// glGenerateMipmap per launch.
+//
+// layout (little endian):
+//   char[4]  "GLTX"
+//   uint32   version (1)
+//   uint32   width, height, mipLevels, format (see GltxFormat)
+//   per mip: uint32 byteSize, then byteSize bytes of pixel/block data
+
+enum GltxFormat : unsigned int {
+    GLTX_RGBA8 = 0, // plain GL_RGBA / GL_UNSIGNED_BYTE
+    GLTX_BC1 = 1,   // GL_COMPRESSED_RGB_S3TC_DXT1_EXT, 8 bytes per 4x4 block
+};
+
+// offline bake step: decode a PNG, build the full mip chain (box filter)
+// and write a .gltx next to it. blockCompress picks BC1 (needs the
+// s3tc extension at runtime, which every desktop driver has)
+bool bakeTextureContainer(const char* imagePath, const char* outPath, bool blockCompress);
+
+// upload a .gltx into the CURRENTLY BOUND GL_TEXTURE_2D, level by level,
+// straight out of the memory-mapped file. returns false if the file is
+// missing or malformed.
+//
+// maxDimension > 0 skips every mip larger than that (keeping at least
+// the smallest one) -- the residency manager uses this to demote a
+// texture to a cheap tail of its chain. outWidth/outHeight, when given,
+// receive the size of the first level actually uploaded
+bool uploadTextureContainer(const char* path, int maxDimension = 0,
+                            int* outWidth = nullptr, int* outHeight = nullptr);
+
+#endif // TEXTURECONTAINER_H
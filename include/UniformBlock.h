@@ -0,0 +1,32 @@
+#ifndef UNIFORMBLOCK_H
+#define UNIFORMBLOCK_H
+
+#include <glad/glad.h>
+
+#include <cstddef>
+#include <string>
+
+// a std140 uniform buffer pinned to a fixed binding point. shared
+// per-frame data (camera matrices, time, ...) goes in here ONCE per
+// frame with upload(), and every shader that declares the block sees it
+// after a single bindUniformBlock() call at link time -- no more
+// re-pushing the same uniforms program by program.
+class UniformBlock {
+    public:
+        UniformBlock(const std::string &name, unsigned int bindingPoint, size_t byteSize);
+        ~UniformBlock();
+
+        // replace (part of) the buffer contents; one glBufferSubData
+        void upload(const void* data, size_t bytes, size_t offset = 0);
+
+        const std::string& getName() const { return name; }
+        unsigned int getBindingPoint() const { return bindingPoint; }
+
+    private:
+        std::string name;
+        unsigned int bindingPoint;
+        unsigned int UBO;
+        size_t byteSize;
+};
+
+#endif // UNIFORMBLOCK_H
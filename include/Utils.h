@@ -6,7 +6,7 @@
 #include <filesystem>
 #include <unistd.h>
 
-std::string getExecutableDir() {
+inline std::string getExecutableDir() {
     char buffer[1024];
     ssize_t len = readlink("/proc/self/exe", buffer, sizeof(buffer) - 1);
     if (len != -1) {
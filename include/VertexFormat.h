@@ -0,0 +1,165 @@
+#ifndef VERTEXFORMAT_H
+#define VERTEXFORMAT_H
+
+#include <glad/glad.h>
+#include <cstdint>
+#include <vector>
+
+#include "Mesh.h"
+
+// compile-time vertex descriptions. VertexLayout (Mesh.h) describes a
+// vertex at runtime; this header describes one in the type system, so
+// stride, offsets and GL enums are constants the compiler folds away and
+// the vertex STRUCT and the GPU layout physically cannot drift apart:
+//
+//     using WorldVertex = Vertex<Position3f, Color3f, TexCoord2f>;
+//     std::vector<WorldVertex> vertices = {...};   // typed, not floats
+//     MeshT<WorldVertex> mesh(vertices, indices);
+//
+// each attribute tag is a tiny POD carrying both the data members and
+// the glVertexAttribPointer parameters; Vertex<...> inherits them in
+// order, and a static_assert rejects any composition the compiler pads
+// (padding is what used to silently corrupt packed asset blobs).
+//
+// the locations are FIXED per tag (position 0, color 1, uv 2), so any
+// shader drawn with these formats must declare its inputs at the same
+// slots -- a mismatch doesn't error, the attribute just silently reads
+// its constant default.
+
+struct Position3f {
+    float x, y, z;
+    static constexpr unsigned int location = 0;
+    static constexpr int components = 3;
+    static constexpr GLenum type = GL_FLOAT;
+    static constexpr bool normalized = false;
+};
+
+struct Position2f {
+    float x, y;
+    static constexpr unsigned int location = 0;
+    static constexpr int components = 2;
+    static constexpr GLenum type = GL_FLOAT;
+    static constexpr bool normalized = false;
+};
+
+struct Color3f {
+    float r, g, b;
+    static constexpr unsigned int location = 1;
+    static constexpr int components = 3;
+    static constexpr GLenum type = GL_FLOAT;
+    static constexpr bool normalized = false;
+};
+
+// 4 bytes instead of 12; the GL normalizes back to [0,1]
+struct Color4b {
+    unsigned char r, g, b, a;
+    static constexpr unsigned int location = 1;
+    static constexpr int components = 4;
+    static constexpr GLenum type = GL_UNSIGNED_BYTE;
+    static constexpr bool normalized = true;
+};
+
+struct TexCoord2f {
+    float u, v;
+    static constexpr unsigned int location = 2;
+    static constexpr int components = 2;
+    static constexpr GLenum type = GL_FLOAT;
+    static constexpr bool normalized = false;
+};
+
+// half floats, 4 bytes instead of 8 (fill with a float->half pack)
+struct TexCoord2h {
+    std::uint16_t u, v;
+    static constexpr unsigned int location = 2;
+    static constexpr int components = 2;
+    static constexpr GLenum type = GL_HALF_FLOAT;
+    static constexpr bool normalized = false;
+};
+
+namespace vertexformat_detail {
+
+    // byte offset of attribute T inside the pack (sum of sizes before it)
+    template<typename T, typename First, typename... Rest>
+    struct OffsetOf {
+        static constexpr unsigned int value = sizeof(First) + OffsetOf<T, Rest...>::value;
+    };
+    template<typename T, typename... Rest>
+    struct OffsetOf<T, T, Rest...> {
+        static constexpr unsigned int value = 0;
+    };
+
+} // namespace vertexformat_detail
+
+template<typename... Attributes>
+struct Vertex : Attributes... {
+
+    static constexpr unsigned int stride()
+    {
+        return (sizeof(Attributes) + ... + 0);
+    }
+
+    template<typename A>
+    static constexpr unsigned int offsetOf()
+    {
+        return vertexformat_detail::OffsetOf<A, Attributes...>::value;
+    }
+
+    // mirror of this type for code that still wants the runtime form
+    // (Mesh's constructors take one)
+    static VertexLayout layout()
+    {
+        VertexLayout result;
+        (result.add(Attributes::location, Attributes::components,
+                    Attributes::type, Attributes::normalized), ...);
+        return result;
+    }
+
+    // the exact glVertexAttribPointer sequence for this layout, every
+    // argument a compile-time constant -- for code that builds its own
+    // VAO (StaticBatch does). expects the VBO to be bound
+    static void enableAttributes()
+    {
+        (enableOne<Attributes>(), ...);
+    }
+
+    private:
+        template<typename A>
+        static void enableOne()
+        {
+            glVertexAttribPointer(A::location, A::components, A::type,
+                                  A::normalized ? GL_TRUE : GL_FALSE,
+                                  stride(), (void*)(uintptr_t)offsetOf<A>());
+            glEnableVertexAttribArray(A::location);
+        }
+};
+
+// the 8-float interleaved layout the engine has always used, now with a
+// compile-time definition (VertexLayout::standard() is its runtime twin)
+using StandardVertex = Vertex<Position3f, Color3f, TexCoord2f>;
+
+// typed facade over Mesh: vertices go in as a span of VertexT instead of
+// a float blob, and the upload size/layout agreement is checked by the
+// compiler instead of trusted. adds no state of its own, so moving and
+// pooling behave exactly like Mesh
+template<typename VertexT>
+class MeshT : public Mesh {
+        static_assert(sizeof(VertexT) == VertexT::stride(),
+                      "compiler padded the vertex struct; it no longer matches the GPU layout");
+
+    public:
+        MeshT(const std::vector<VertexT>& vertices, const std::vector<unsigned int>& indices,
+              GLenum drawMode = GL_TRIANGLES)
+            : Mesh(vertices.data(), vertices.size() * sizeof(VertexT),
+                   VertexT::layout(), indices, drawMode)
+        {
+        }
+
+        // dynamic variant; beginDynamicWrite() regions hold VertexT
+        MeshT(size_t maxVertices, const std::vector<unsigned int>& indices,
+              GLenum drawMode = GL_TRIANGLES)
+            : Mesh(maxVertices, VertexT::layout(), indices, drawMode)
+        {
+        }
+};
+
+#endif // VERTEXFORMAT_H
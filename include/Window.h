@@ -11,19 +11,53 @@ class Window
 {
     public:
         Window(int width, int height, const char* title);
+
+        // headless mode for server-side batch rendering: the GLFW window
+        // is created hidden, rendering goes into an offscreen FBO and
+        // there is no vsync'd swap -> throughput is bound by GPU time,
+        // not the monitor
+        Window(int width, int height, const char* title, bool headless);
+
         ~Window();
 
-        bool windowShouldClose();  
-        void swapBuffers();        
-        void pollEvents();         
-        void processInput();       
+        bool windowShouldClose();
+
+        // how many vsyncs swapBuffers waits for. 1 (the GLFW default) is
+        // classic vsync; 0 presents the latest finished frame immediately
+        // -- the closest GL gets to mailbox presentation, and the lowest
+        // input latency when paired with a fixed-timestep sim loop
+        void setSwapInterval(int interval);
+
+        void swapBuffers();
+        void pollEvents();
+        void processInput();
+
+        bool isHeadless() const { return headless; }
+
+        // headless only: read a finished frame into `pixels` (RGBA8,
+        // width*height*4 bytes). readback is double buffered through
+        // PIXEL_PACK PBOs so the call never waits on the GPU -- it hands
+        // back the PREVIOUS frame, and false until one is available
+        bool renderFrameTo(unsigned char* pixels);
+
+        int getWidth() const { return width; }
+        int getHeight() const { return height; }
 
         static void framebuffer_size_callback(GLFWwindow* window, int width, int height);
 
     private:
+        void createOffscreenTarget();
+
         int width, height;
         const char* title;
         GLFWwindow* window;
+
+        // headless render target + async readback state
+        bool headless = false;
+        unsigned int FBO = 0, colorRBO = 0, depthRBO = 0;
+        unsigned int readPBO[2] = {0, 0};
+        int readIndex = 0;
+        bool readPrimed = false; // a readback is parked in the other PBO
 };
 
-#endif
\ No newline at end of file
+#endif
@@ -0,0 +1,248 @@
+#include <DebugText.h>
+
+#include <cstring>
+#include <iostream>
+
+#include "GLStateCache.h"
+#include "Utils.h"
+
+// glyphs sit 16 per row in the atlas -> a 128x32 single-channel texture
+static const int GLYPH_SIZE = 8;
+static const int ATLAS_COLS = 16;
+static const int ATLAS_ROWS = 4;
+static const int FIRST_GLYPH = 32; // ' '
+static const int GLYPH_COUNT = ATLAS_COLS * ATLAS_ROWS; // ASCII 32..95
+
+// a unit the scene textures don't use, so the renderer's bind tracking
+// and the overlay never fight over the same slot
+static const int FONT_UNIT = 15;
+
+// quad budget per flush; a full stats page is a few hundred glyphs
+static const size_t MAX_GLYPHS = 1024;
+
+// 8x8 bitmap font for ASCII 32..95, one byte per pixel row with bit 0 as
+// the leftmost column. glyph shapes from the public domain font8x8 set --
+// baked into a texture at startup so no font file or library is needed
+static const unsigned char FONT_ROWS[GLYPH_COUNT][GLYPH_SIZE] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // ' '
+    {0x18, 0x3C, 0x3C, 0x18, 0x18, 0x00, 0x18, 0x00}, // '!'
+    {0x36, 0x36, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}, // '"'
+    {0x36, 0x36, 0x7F, 0x36, 0x7F, 0x36, 0x36, 0x00}, // '#'
+    {0x0C, 0x3E, 0x03, 0x1E, 0x30, 0x1F, 0x0C, 0x00}, // '$'
+    {0x00, 0x63, 0x33, 0x18, 0x0C, 0x66, 0x63, 0x00}, // '%'
+    {0x1C, 0x36, 0x1C, 0x6E, 0x3B, 0x33, 0x6E, 0x00}, // '&'
+    {0x06, 0x06, 0x03, 0x00, 0x00, 0x00, 0x00, 0x00}, // '\''
+    {0x18, 0x0C, 0x06, 0x06, 0x06, 0x0C, 0x18, 0x00}, // '('
+    {0x06, 0x0C, 0x18, 0x18, 0x18, 0x0C, 0x06, 0x00}, // ')'
+    {0x00, 0x66, 0x3C, 0xFF, 0x3C, 0x66, 0x00, 0x00}, // '*'
+    {0x00, 0x0C, 0x0C, 0x3F, 0x0C, 0x0C, 0x00, 0x00}, // '+'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x06}, // ','
+    {0x00, 0x00, 0x00, 0x3F, 0x00, 0x00, 0x00, 0x00}, // '-'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C, 0x00}, // '.'
+    {0x60, 0x30, 0x18, 0x0C, 0x06, 0x03, 0x01, 0x00}, // '/'
+    {0x3E, 0x63, 0x73, 0x7B, 0x6F, 0x67, 0x3E, 0x00}, // '0'
+    {0x0C, 0x0E, 0x0C, 0x0C, 0x0C, 0x0C, 0x3F, 0x00}, // '1'
+    {0x1E, 0x33, 0x30, 0x1C, 0x06, 0x33, 0x3F, 0x00}, // '2'
+    {0x1E, 0x33, 0x30, 0x1C, 0x30, 0x33, 0x1E, 0x00}, // '3'
+    {0x38, 0x3C, 0x36, 0x33, 0x7F, 0x30, 0x78, 0x00}, // '4'
+    {0x3F, 0x03, 0x1F, 0x30, 0x30, 0x33, 0x1E, 0x00}, // '5'
+    {0x1C, 0x06, 0x03, 0x1F, 0x33, 0x33, 0x1E, 0x00}, // '6'
+    {0x3F, 0x33, 0x30, 0x18, 0x0C, 0x0C, 0x0C, 0x00}, // '7'
+    {0x1E, 0x33, 0x33, 0x1E, 0x33, 0x33, 0x1E, 0x00}, // '8'
+    {0x1E, 0x33, 0x33, 0x3E, 0x30, 0x18, 0x0E, 0x00}, // '9'
+    {0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x00}, // ':'
+    {0x00, 0x0C, 0x0C, 0x00, 0x00, 0x0C, 0x0C, 0x06}, // ';'
+    {0x18, 0x0C, 0x06, 0x03, 0x06, 0x0C, 0x18, 0x00}, // '<'
+    {0x00, 0x00, 0x3F, 0x00, 0x00, 0x3F, 0x00, 0x00}, // '='
+    {0x06, 0x0C, 0x18, 0x30, 0x18, 0x0C, 0x06, 0x00}, // '>'
+    {0x1E, 0x33, 0x30, 0x18, 0x0C, 0x00, 0x0C, 0x00}, // '?'
+    {0x3E, 0x63, 0x7B, 0x7B, 0x7B, 0x03, 0x1E, 0x00}, // '@'
+    {0x0C, 0x1E, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x00}, // 'A'
+    {0x3F, 0x66, 0x66, 0x3E, 0x66, 0x66, 0x3F, 0x00}, // 'B'
+    {0x3C, 0x66, 0x03, 0x03, 0x03, 0x66, 0x3C, 0x00}, // 'C'
+    {0x1F, 0x36, 0x66, 0x66, 0x66, 0x36, 0x1F, 0x00}, // 'D'
+    {0x7F, 0x46, 0x16, 0x1E, 0x16, 0x46, 0x7F, 0x00}, // 'E'
+    {0x7F, 0x46, 0x16, 0x1E, 0x16, 0x06, 0x0F, 0x00}, // 'F'
+    {0x3C, 0x66, 0x03, 0x03, 0x73, 0x66, 0x7C, 0x00}, // 'G'
+    {0x33, 0x33, 0x33, 0x3F, 0x33, 0x33, 0x33, 0x00}, // 'H'
+    {0x1E, 0x0C, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // 'I'
+    {0x78, 0x30, 0x30, 0x30, 0x33, 0x33, 0x1E, 0x00}, // 'J'
+    {0x67, 0x66, 0x36, 0x1E, 0x36, 0x66, 0x67, 0x00}, // 'K'
+    {0x0F, 0x06, 0x06, 0x06, 0x46, 0x66, 0x7F, 0x00}, // 'L'
+    {0x63, 0x77, 0x7F, 0x7F, 0x6B, 0x63, 0x63, 0x00}, // 'M'
+    {0x63, 0x67, 0x6F, 0x7B, 0x73, 0x63, 0x63, 0x00}, // 'N'
+    {0x1C, 0x36, 0x63, 0x63, 0x63, 0x36, 0x1C, 0x00}, // 'O'
+    {0x3F, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x0F, 0x00}, // 'P'
+    {0x1E, 0x33, 0x33, 0x33, 0x3B, 0x1E, 0x38, 0x00}, // 'Q'
+    {0x3F, 0x66, 0x66, 0x3E, 0x36, 0x66, 0x67, 0x00}, // 'R'
+    {0x1E, 0x33, 0x07, 0x0E, 0x38, 0x33, 0x1E, 0x00}, // 'S'
+    {0x3F, 0x2D, 0x0C, 0x0C, 0x0C, 0x0C, 0x1E, 0x00}, // 'T'
+    {0x33, 0x33, 0x33, 0x33, 0x33, 0x33, 0x3F, 0x00}, // 'U'
+    {0x33, 0x33, 0x33, 0x33, 0x33, 0x1E, 0x0C, 0x00}, // 'V'
+    {0x63, 0x63, 0x63, 0x6B, 0x7F, 0x77, 0x63, 0x00}, // 'W'
+    {0x63, 0x63, 0x36, 0x1C, 0x1C, 0x36, 0x63, 0x00}, // 'X'
+    {0x33, 0x33, 0x33, 0x1E, 0x0C, 0x0C, 0x1E, 0x00}, // 'Y'
+    {0x7F, 0x63, 0x31, 0x18, 0x4C, 0x66, 0x7F, 0x00}, // 'Z'
+    {0x1E, 0x06, 0x06, 0x06, 0x06, 0x06, 0x1E, 0x00}, // '['
+    {0x03, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x40, 0x00}, // '\'
+    {0x1E, 0x18, 0x18, 0x18, 0x18, 0x18, 0x1E, 0x00}, // ']'
+    {0x08, 0x1C, 0x36, 0x63, 0x00, 0x00, 0x00, 0x00}, // '^'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0xFF}, // '_'
+};
+
+// index pattern for MAX_GLYPHS quads -- built once, stays static in the
+// EBO while the vertices are rewritten every flush
+static std::vector<unsigned int> quadIndices()
+{
+    std::vector<unsigned int> indices;
+    indices.reserve(MAX_GLYPHS * 6);
+    for (unsigned int quad = 0; quad < MAX_GLYPHS; quad++)
+    {
+        unsigned int base = quad * 4;
+        indices.push_back(base);
+        indices.push_back(base + 1);
+        indices.push_back(base + 2);
+        indices.push_back(base + 2);
+        indices.push_back(base + 3);
+        indices.push_back(base);
+    }
+    return indices;
+}
+
+DebugText::DebugText()
+    : shader((getExecutableDir() + "/vs/text.vert").c_str(),
+             (getExecutableDir() + "/fs/text.frag").c_str()),
+      mesh(MAX_GLYPHS * 4, quadIndices())
+{
+    bakeFontAtlas();
+
+    // sampler unit and color never change; set them once
+    shader.initialize();
+    shader.setInt("fontAtlas", FONT_UNIT);
+    shader.setVec3("textColor", glm::vec3(1.0f, 1.0f, 1.0f));
+}
+
+void DebugText::bakeFontAtlas()
+{
+    unsigned char pixels[ATLAS_ROWS * GLYPH_SIZE][ATLAS_COLS * GLYPH_SIZE];
+
+    for (int glyph = 0; glyph < GLYPH_COUNT; glyph++)
+    {
+        int originX = (glyph % ATLAS_COLS) * GLYPH_SIZE;
+        int originY = (glyph / ATLAS_COLS) * GLYPH_SIZE;
+
+        for (int row = 0; row < GLYPH_SIZE; row++)
+        {
+            unsigned char bits = FONT_ROWS[glyph][row];
+            for (int column = 0; column < GLYPH_SIZE; column++)
+            {
+                pixels[originY + row][originX + column] = (bits >> column) & 1 ? 255 : 0;
+            }
+        }
+    }
+
+    glGenTextures(1, &fontTexture);
+    GLStateCache::shared().bindTextureUnit(FONT_UNIT, fontTexture);
+
+    // single channel rows aren't 4-byte aligned guarantees; be explicit
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RED, ATLAS_COLS * GLYPH_SIZE, ATLAS_ROWS * GLYPH_SIZE,
+                 0, GL_RED, GL_UNSIGNED_BYTE, pixels);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+
+    // crisp pixels, no mips, no bleeding between neighbouring glyphs
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, 0);
+}
+
+void DebugText::addText(float x, float y, const std::string &text, float scale)
+{
+    float advance = GLYPH_SIZE * scale;
+    float penX = x;
+    float penY = y;
+
+    for (char character : text)
+    {
+        if (character == '\n')
+        {
+            penX = x;
+            penY += advance;
+            continue;
+        }
+
+        int code = (unsigned char)character;
+        if (code >= 'a' && code <= 'z')
+        {
+            code -= 'a' - 'A'; // fold onto the uppercase glyphs
+        }
+        if (code < FIRST_GLYPH || code >= FIRST_GLYPH + GLYPH_COUNT)
+        {
+            code = '?';
+        }
+
+        if (code == ' ')
+        {
+            penX += advance; // nothing to draw, just move the pen
+            continue;
+        }
+
+        if (staging.size() / 4 >= MAX_GLYPHS)
+        {
+            return; // budget spent; the rest of the string is dropped
+        }
+
+        int glyph = code - FIRST_GLYPH;
+        float u0 = (float)(glyph % ATLAS_COLS) / ATLAS_COLS;
+        float v0 = (float)(glyph / ATLAS_COLS) / ATLAS_ROWS;
+        float u1 = u0 + 1.0f / ATLAS_COLS;
+        float v1 = v0 + 1.0f / ATLAS_ROWS;
+
+        staging.push_back({penX, penY, u0, v0});
+        staging.push_back({penX + advance, penY, u1, v0});
+        staging.push_back({penX + advance, penY + advance, u1, v1});
+        staging.push_back({penX, penY + advance, u0, v1});
+
+        penX += advance;
+    }
+}
+
+void DebugText::flush(int screenWidth, int screenHeight)
+{
+    if (staging.empty())
+    {
+        return;
+    }
+
+    // one write into the mesh's current region, one draw for everything
+    void* destination = mesh.beginDynamicWrite();
+    if (destination == nullptr)
+    {
+        staging.clear();
+        return;
+    }
+    std::memcpy(destination, staging.data(), staging.size() * sizeof(GlyphVertex));
+
+    unsigned int quads = (unsigned int)(staging.size() / 4);
+    mesh.endDynamicWrite(quads * 4, quads * 6);
+
+    shader.initialize();
+    shader.setVec2("screenSize", glm::vec2((float)screenWidth, (float)screenHeight));
+
+    GLStateCache::shared().bindTextureUnit(FONT_UNIT, fontTexture);
+
+    mesh.bind_VAO();
+    glDrawElementsBaseVertex(GL_TRIANGLES, mesh.getIndexCount(), GL_UNSIGNED_INT, 0,
+                             mesh.getBaseVertex());
+    mesh.unbind_VAO();
+
+    staging.clear();
+}
+
+DebugText::~DebugText()
+{
+    glDeleteTextures(1, &fontTexture);
+    GLStateCache::shared().onTextureDeleted(fontTexture);
+}
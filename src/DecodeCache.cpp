@@ -0,0 +1,176 @@
+#include "DecodeCache.h"
+
+#include <stb_image/stb_image.h>
+
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+static const char GLDC_MAGIC[4] = {'G', 'L', 'D', 'C'};
+static const std::uint32_t GLDC_VERSION = 1;
+
+// sidecar header, written in front of the raw pixel blob. mtime + byte
+// size of the SOURCE file stand in for a content hash: cheap to check,
+// and good enough to catch every normal way an image changes on disk
+struct CacheHeader {
+    char magic[4];
+    std::uint32_t version;
+    std::int32_t width;
+    std::int32_t height;
+    std::int32_t channels;
+    std::int64_t sourceMtime;
+    std::int64_t sourceSize;
+};
+
+// cachedDecodeFree has to know whether a pointer came from a mapping
+// (munmap base + length) or from stbi. decode jobs run on several
+// worker threads at once, hence the lock
+struct Mapping {
+    void* base;
+    size_t length;
+};
+static std::unordered_map<const unsigned char*, Mapping> liveMappings;
+static std::mutex mappingsMutex;
+
+// mmap the sidecar and hand out its pixel blob if it still matches the
+// source file; nullptr on any mismatch or error
+static unsigned char* tryReadCache(const std::string& cachePath,
+                                   const struct stat& sourceInfo,
+                                   int* width, int* height, int* channels)
+{
+    int fd = open(cachePath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return nullptr;
+    }
+
+    struct stat cacheInfo;
+    if (fstat(fd, &cacheInfo) != 0 || (size_t)cacheInfo.st_size <= sizeof(CacheHeader))
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    void* base = mmap(nullptr, cacheInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        return nullptr;
+    }
+
+    CacheHeader header;
+    std::memcpy(&header, base, sizeof(header));
+
+    bool valid = std::memcmp(header.magic, GLDC_MAGIC, 4) == 0
+              && header.version == GLDC_VERSION
+              && header.sourceMtime == (std::int64_t)sourceInfo.st_mtime
+              && header.sourceSize == (std::int64_t)sourceInfo.st_size
+              && header.width > 0 && header.height > 0
+              && header.channels > 0 && header.channels <= 4
+              && (size_t)cacheInfo.st_size == sizeof(CacheHeader) +
+                     (size_t)header.width * header.height * header.channels;
+    if (!valid)
+    {
+        munmap(base, cacheInfo.st_size);
+        return nullptr;
+    }
+
+    *width = header.width;
+    *height = header.height;
+    *channels = header.channels;
+
+    unsigned char* pixels = (unsigned char*)base + sizeof(CacheHeader);
+    {
+        std::lock_guard<std::mutex> lock(mappingsMutex);
+        liveMappings[pixels] = {base, (size_t)cacheInfo.st_size};
+    }
+    return pixels;
+}
+
+// write-to-temp + rename, so a crash mid-write or two threads decoding
+// the same image never leave a torn sidecar behind
+static void writeCache(const std::string& cachePath, const struct stat& sourceInfo,
+                       const unsigned char* pixels, int width, int height, int channels)
+{
+    std::string tempPath = cachePath + ".tmp." + std::to_string((unsigned long)getpid());
+
+    std::FILE* file = std::fopen(tempPath.c_str(), "wb");
+    if (file == nullptr)
+    {
+        return; // read-only asset dir -> the cache just never kicks in
+    }
+
+    CacheHeader header;
+    std::memcpy(header.magic, GLDC_MAGIC, 4);
+    header.version = GLDC_VERSION;
+    header.width = width;
+    header.height = height;
+    header.channels = channels;
+    header.sourceMtime = (std::int64_t)sourceInfo.st_mtime;
+    header.sourceSize = (std::int64_t)sourceInfo.st_size;
+
+    size_t pixelBytes = (size_t)width * height * channels;
+    bool ok = std::fwrite(&header, sizeof(header), 1, file) == 1
+           && std::fwrite(pixels, 1, pixelBytes, file) == pixelBytes;
+    std::fclose(file);
+
+    if (!ok || std::rename(tempPath.c_str(), cachePath.c_str()) != 0)
+    {
+        std::remove(tempPath.c_str());
+    }
+}
+
+unsigned char* cachedDecode(const char* path, int* width, int* height, int* channels)
+{
+    struct stat sourceInfo;
+    if (stat(path, &sourceInfo) != 0)
+    {
+        // no source to validate against; let stbi produce the error
+        return stbi_load(path, width, height, channels, 0);
+    }
+
+    std::string cachePath = std::string(path) + ".gldc";
+
+    unsigned char* cached = tryReadCache(cachePath, sourceInfo, width, height, channels);
+    if (cached != nullptr)
+    {
+        return cached;
+    }
+
+    unsigned char* pixels = stbi_load(path, width, height, channels, 0);
+    if (pixels != nullptr)
+    {
+        writeCache(cachePath, sourceInfo, pixels, *width, *height, *channels);
+    }
+    return pixels;
+}
+
+void cachedDecodeFree(unsigned char* pixels)
+{
+    if (pixels == nullptr)
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mappingsMutex);
+        auto found = liveMappings.find(pixels);
+        if (found != liveMappings.end())
+        {
+            munmap(found->second.base, found->second.length);
+            liveMappings.erase(found);
+            return;
+        }
+    }
+
+    stbi_image_free(pixels);
+}
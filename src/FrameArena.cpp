@@ -0,0 +1,70 @@
+#include <FrameArena.h>
+
+#include <algorithm>
+#include <cstdint>
+
+FrameArena::FrameArena(size_t blockBytes)
+    : blockBytes(blockBytes)
+{
+    blocks.push_back({new unsigned char[blockBytes], blockBytes});
+}
+
+FrameArena::~FrameArena()
+{
+    for (const Block& block : blocks)
+    {
+        delete[] block.memory;
+    }
+}
+
+FrameArena::Block& FrameArena::blockWithRoom(size_t bytes)
+{
+    // move to the next block (grabbing a fresh one if none is left).
+    // oversized requests get a dedicated block of exactly their size, so
+    // one huge allocation doesn't force every later block to be huge
+    currentBlock++;
+    if (currentBlock == blocks.size())
+    {
+        blocks.push_back({new unsigned char[std::max(bytes, blockBytes)],
+                          std::max(bytes, blockBytes)});
+    }
+    else if (blocks[currentBlock].size < bytes)
+    {
+        delete[] blocks[currentBlock].memory;
+        blocks[currentBlock] = {new unsigned char[bytes], bytes};
+    }
+
+    cursor = 0;
+    return blocks[currentBlock];
+}
+
+void* FrameArena::allocate(size_t bytes, size_t alignment)
+{
+    Block* block = &blocks[currentBlock];
+
+    size_t aligned = (cursor + alignment - 1) & ~(alignment - 1);
+    if (aligned + bytes > block->size)
+    {
+        block = &blockWithRoom(bytes);
+        aligned = 0;
+    }
+
+    cursor = aligned + bytes;
+    frameBytes += bytes;
+    highWaterMark = std::max(highWaterMark, frameBytes);
+
+    return block->memory + aligned;
+}
+
+void FrameArena::reset()
+{
+    currentBlock = 0;
+    cursor = 0;
+    frameBytes = 0;
+}
+
+FrameArena& FrameArena::threadLocal()
+{
+    static thread_local FrameArena arena;
+    return arena;
+}
@@ -0,0 +1,98 @@
+#include <Frustum.h>
+
+#include <cmath>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+void Frustum::setFromMatrix(const glm::mat4 &viewProjection)
+{
+    // Gribb/Hartmann: each plane is a sum/difference of matrix rows.
+    // glm is column major, so row i of the matrix is m[0][i]..m[3][i]
+    glm::vec4 rows[4];
+    for (int i = 0; i < 4; i++)
+    {
+        rows[i] = glm::vec4(viewProjection[0][i], viewProjection[1][i],
+                            viewProjection[2][i], viewProjection[3][i]);
+    }
+
+    glm::vec4 planes[6] = {
+        rows[3] + rows[0], // left
+        rows[3] - rows[0], // right
+        rows[3] + rows[1], // bottom
+        rows[3] - rows[1], // top
+        rows[3] + rows[2], // near
+        rows[3] - rows[2], // far
+    };
+
+    for (int i = 0; i < 6; i++)
+    {
+        // normalize so plane distances compare against real-world radii
+        float length = std::sqrt(planes[i].x * planes[i].x
+                               + planes[i].y * planes[i].y
+                               + planes[i].z * planes[i].z);
+        if (length > 0.0f)
+        {
+            planeX[i] = planes[i].x / length;
+            planeY[i] = planes[i].y / length;
+            planeZ[i] = planes[i].z / length;
+            planeW[i] = planes[i].w / length;
+        }
+    }
+}
+
+bool Frustum::testSphere(const glm::vec3 &center, float radius) const
+{
+    for (int i = 0; i < 6; i++)
+    {
+        float distance = planeX[i] * center.x + planeY[i] * center.y
+                       + planeZ[i] * center.z + planeW[i];
+        if (distance < -radius)
+        {
+            return false; // fully behind one plane -> out
+        }
+    }
+    return true;
+}
+
+void Frustum::cullSpheres(const float* centerX, const float* centerY, const float* centerZ,
+                          const float* radius, size_t count, unsigned char* visible) const
+{
+    size_t sphere = 0;
+
+#ifdef __SSE2__
+    for (; sphere + 4 <= count; sphere += 4)
+    {
+        __m128 x = _mm_loadu_ps(centerX + sphere);
+        __m128 y = _mm_loadu_ps(centerY + sphere);
+        __m128 z = _mm_loadu_ps(centerZ + sphere);
+        __m128 negRadius = _mm_sub_ps(_mm_setzero_ps(), _mm_loadu_ps(radius + sphere));
+
+        // a sphere stays visible while it is not fully behind any plane
+        __m128 inside = _mm_castsi128_ps(_mm_set1_epi32(-1));
+        for (int plane = 0; plane < 6; plane++)
+        {
+            __m128 distance = _mm_add_ps(
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planeX[plane]), x),
+                           _mm_mul_ps(_mm_set1_ps(planeY[plane]), y)),
+                _mm_add_ps(_mm_mul_ps(_mm_set1_ps(planeZ[plane]), z),
+                           _mm_set1_ps(planeW[plane])));
+            inside = _mm_and_ps(inside, _mm_cmpge_ps(distance, negRadius));
+        }
+
+        int mask = _mm_movemask_ps(inside);
+        visible[sphere + 0] = (mask >> 0) & 1;
+        visible[sphere + 1] = (mask >> 1) & 1;
+        visible[sphere + 2] = (mask >> 2) & 1;
+        visible[sphere + 3] = (mask >> 3) & 1;
+    }
+#endif
+
+    // scalar tail (and the whole thing on non-SSE targets)
+    for (; sphere < count; sphere++)
+    {
+        visible[sphere] = testSphere(
+            glm::vec3(centerX[sphere], centerY[sphere], centerZ[sphere]), radius[sphere]) ? 1 : 0;
+    }
+}
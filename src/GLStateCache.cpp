@@ -0,0 +1,152 @@
+#include <GLStateCache.h>
+
+#include <glad/glad.h>
+
+GLStateCache& GLStateCache::shared()
+{
+    static GLStateCache instance;
+    return instance;
+}
+
+GLStateCache::GLStateCache()
+{
+    // a fresh context is in a known state, so the shadow can start from
+    // the GL defaults instead of UNKNOWN everywhere
+    currentProgram = 0;
+    currentVAO = 0;
+    currentUnit = 0;
+    for (int unit = 0; unit < MAX_UNITS; unit++)
+    {
+        boundTexture[unit] = 0;
+    }
+    currentClearColor[0] = currentClearColor[1] = currentClearColor[2] = currentClearColor[3] = 0.0f;
+    clearColorKnown = true;
+}
+
+void GLStateCache::useProgram(unsigned int program)
+{
+    if (currentProgram == program)
+    {
+        elidedCalls++;
+        return;
+    }
+    glUseProgram(program);
+    currentProgram = program;
+    issuedCalls++;
+}
+
+void GLStateCache::bindVertexArray(unsigned int vao)
+{
+    if (currentVAO == vao)
+    {
+        elidedCalls++;
+        return;
+    }
+    glBindVertexArray(vao);
+    currentVAO = vao;
+    issuedCalls++;
+}
+
+void GLStateCache::activeTexture(unsigned int unit)
+{
+    if (currentUnit == unit)
+    {
+        elidedCalls++;
+        return;
+    }
+    glActiveTexture(GL_TEXTURE0 + unit);
+    currentUnit = unit;
+    issuedCalls++;
+}
+
+void GLStateCache::bindTexture2D(unsigned int id)
+{
+    // active unit unknown (or past the shadow array -- activeTexture
+    // stores whatever unit it is given) -> no slot to check or record
+    // against, issue the bind blindly
+    if (currentUnit >= (unsigned int)MAX_UNITS)
+    {
+        glBindTexture(GL_TEXTURE_2D, id);
+        issuedCalls++;
+        return;
+    }
+    if (boundTexture[currentUnit] == id)
+    {
+        elidedCalls++;
+        return;
+    }
+    glBindTexture(GL_TEXTURE_2D, id);
+    boundTexture[currentUnit] = id;
+    issuedCalls++;
+}
+
+void GLStateCache::bindTextureUnit(unsigned int unit, unsigned int id)
+{
+    // when the bind would be elided anyway, skip the unit switch too.
+    // sampling only cares about the unit -> id pairing, but it means the
+    // active unit is left wherever it was -- see the header contract
+    if (unit < MAX_UNITS && boundTexture[unit] == id)
+    {
+        elidedCalls += 2;
+        return;
+    }
+    activeTexture(unit);
+    bindTexture2D(id);
+}
+
+void GLStateCache::clearColor(float r, float g, float b, float a)
+{
+    if (clearColorKnown &&
+        currentClearColor[0] == r && currentClearColor[1] == g &&
+        currentClearColor[2] == b && currentClearColor[3] == a)
+    {
+        elidedCalls++;
+        return;
+    }
+    glClearColor(r, g, b, a);
+    currentClearColor[0] = r;
+    currentClearColor[1] = g;
+    currentClearColor[2] = b;
+    currentClearColor[3] = a;
+    clearColorKnown = true;
+    issuedCalls++;
+}
+
+void GLStateCache::onProgramDeleted(unsigned int program)
+{
+    if (currentProgram == program)
+    {
+        currentProgram = UNKNOWN;
+    }
+}
+
+void GLStateCache::onVertexArrayDeleted(unsigned int vao)
+{
+    if (currentVAO == vao)
+    {
+        currentVAO = UNKNOWN;
+    }
+}
+
+void GLStateCache::onTextureDeleted(unsigned int id)
+{
+    for (int unit = 0; unit < MAX_UNITS; unit++)
+    {
+        if (boundTexture[unit] == id)
+        {
+            boundTexture[unit] = UNKNOWN;
+        }
+    }
+}
+
+void GLStateCache::invalidate()
+{
+    currentProgram = UNKNOWN;
+    currentVAO = UNKNOWN;
+    currentUnit = UNKNOWN;
+    for (int unit = 0; unit < MAX_UNITS; unit++)
+    {
+        boundTexture[unit] = UNKNOWN;
+    }
+    clearColorKnown = false;
+}
@@ -0,0 +1,137 @@
+#include <JobSystem.h>
+
+JobSystem::JobSystem(unsigned int threadCount)
+{
+    if (threadCount == 0)
+    {
+        unsigned int hardware = std::thread::hardware_concurrency();
+        threadCount = (hardware > 1) ? hardware - 1 : 1;
+    }
+
+    for (unsigned int i = 0; i < threadCount; i++)
+    {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+    for (unsigned int i = 0; i < threadCount; i++)
+    {
+        workers.emplace_back([this, i]() { workerLoop(i); });
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    // the flag flip must happen under sleepMutex: a worker that just saw
+    // stopping == false could otherwise block right after the notify and
+    // sleep through shutdown, hanging the join below
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (std::thread& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+void JobSystem::submit(std::function<void()> job)
+{
+    pendingJobs++;
+
+    // round-robin across the worker deques; stealing evens out the rest
+    unsigned int target;
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        target = submitCursor;
+        submitCursor = (submitCursor + 1) % queues.size();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->jobs.push_back(std::move(job));
+    }
+
+    // bump queuedJobs under sleepMutex, AFTER the push: a worker checking
+    // the wait predicate either sees the count (and finds the job already
+    // queued) or is fully blocked when the notify arrives. incrementing
+    // outside the lock let the notify land in the gap between a worker's
+    // predicate check and its block -- a lost wakeup that left the job
+    // sitting until the next submit
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex);
+        queuedJobs++;
+    }
+    workAvailable.notify_one();
+}
+
+bool JobSystem::tryGetJob(unsigned int workerIndex, std::function<void()>& job)
+{
+    // own queue first, from the back (hot end)
+    {
+        WorkerQueue& own = *queues[workerIndex];
+        std::lock_guard<std::mutex> lock(own.mutex);
+        if (!own.jobs.empty())
+        {
+            job = std::move(own.jobs.back());
+            own.jobs.pop_back();
+            queuedJobs--;
+            return true;
+        }
+    }
+
+    // dry -> steal from the front (cold end) of somebody else's queue
+    for (size_t offset = 1; offset < queues.size(); offset++)
+    {
+        WorkerQueue& victim = *queues[(workerIndex + offset) % queues.size()];
+        std::lock_guard<std::mutex> lock(victim.mutex);
+        if (!victim.jobs.empty())
+        {
+            job = std::move(victim.jobs.front());
+            victim.jobs.pop_front();
+            queuedJobs--;
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void JobSystem::workerLoop(unsigned int workerIndex)
+{
+    while (!stopping)
+    {
+        std::function<void()> job;
+        if (tryGetJob(workerIndex, job))
+        {
+            job();
+
+            // same discipline as submit(): take sleepMutex before the
+            // notify so waitIdle is either still ahead of its predicate
+            // check (and sees the zero) or already blocked (and gets the
+            // notify). bare notify_all could fire in between and leave
+            // waitIdle waiting on a count that never changes again
+            if (--pendingJobs == 0)
+            {
+                std::lock_guard<std::mutex> lock(sleepMutex);
+                allDone.notify_all();
+            }
+            continue;
+        }
+
+        // nothing anywhere -> sleep until submit() wakes us
+        std::unique_lock<std::mutex> lock(sleepMutex);
+        workAvailable.wait(lock, [this]() { return stopping || queuedJobs > 0; });
+    }
+}
+
+void JobSystem::waitIdle()
+{
+    std::unique_lock<std::mutex> lock(sleepMutex);
+    allDone.wait(lock, [this]() { return pendingJobs == 0; });
+}
+
+JobSystem& JobSystem::shared()
+{
+    static JobSystem instance;
+    return instance;
+}
@@ -1,59 +1,658 @@
 #include <Mesh.h>
+#include <GLStateCache.h>
+#include <Renderer.h>
 
-Mesh::Mesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices)
-    : indexcount(indices.size())
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <new>
+#include <unordered_map>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// byte size of ONE attribute with the given type and component count
+static unsigned int attributeSize(GLenum type, int components)
+{
+    switch (type)
+    {
+        case GL_FLOAT:
+            return 4 * components;
+        case GL_HALF_FLOAT:
+        case GL_SHORT:
+        case GL_UNSIGNED_SHORT:
+            return 2 * components;
+        case GL_BYTE:
+        case GL_UNSIGNED_BYTE:
+            return 1 * components;
+        // the whole attribute lives in one 32-bit word no matter what
+        case GL_INT_2_10_10_10_REV:
+        case GL_UNSIGNED_INT_2_10_10_10_REV:
+            return 4;
+        default:
+            std::cerr << "ERROR::MESH::UNSUPPORTED_ATTRIBUTE_TYPE: 0x"
+                      << std::hex << type << std::dec << std::endl;
+            return 4 * components;
+    }
+}
+
+VertexLayout& VertexLayout::add(unsigned int location, int components, GLenum type, bool normalized)
+{
+    attributes.push_back({location, components, type, normalized, stride});
+    stride += attributeSize(type, components);
+    return *this;
+}
+
+VertexLayout VertexLayout::standard()
+{
+    // (0,1,2) -> position, color, texcoord -> 8 floats / 32 bytes per vertex
+    return VertexLayout()
+        .add(0, 3, GL_FLOAT)
+        .add(1, 3, GL_FLOAT)
+        .add(2, 2, GL_FLOAT);
+}
+
+Mesh::Mesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices, GLenum drawMode)
+    : Mesh(vertices.data(), vertices.size() * sizeof(float), VertexLayout::standard(), indices, drawMode)
+{
+}
+
+// ---- geometry LOD --------------------------------------------------------
+
+std::vector<unsigned int> Mesh::simplifyIndices(const void* vertexData, size_t vertexDataSize,
+                                                const VertexLayout& layout,
+                                                const std::vector<unsigned int>& indices,
+                                                int gridResolution)
+{
+    // position lookup mirrors computeBounds: location 0, plain 3 floats,
+    // anything else is not simplifiable
+    const VertexLayout::Attribute* position = nullptr;
+    for (const VertexLayout::Attribute& attribute : layout.getAttributes())
+    {
+        if (attribute.location == 0)
+        {
+            position = &attribute;
+            break;
+        }
+    }
+    if (position == nullptr || position->type != GL_FLOAT || position->components < 3
+        || vertexData == nullptr || layout.getStride() == 0 || gridResolution < 1)
+    {
+        return {};
+    }
+
+    size_t vertexCount = vertexDataSize / layout.getStride();
+    const unsigned char* bytes = static_cast<const unsigned char*>(vertexData);
+
+    auto positionAt = [&](size_t vertex) {
+        const float* xyz = reinterpret_cast<const float*>(
+            bytes + vertex * layout.getStride() + position->offset);
+        return glm::vec3(xyz[0], xyz[1], xyz[2]);
+    };
+
+    glm::vec3 minCorner(0.0f), maxCorner(0.0f);
+    for (size_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+        glm::vec3 point = positionAt(vertex);
+        if (vertex == 0)
+        {
+            minCorner = maxCorner = point;
+            continue;
+        }
+        minCorner = glm::vec3(std::min(minCorner.x, point.x), std::min(minCorner.y, point.y), std::min(minCorner.z, point.z));
+        maxCorner = glm::vec3(std::max(maxCorner.x, point.x), std::max(maxCorner.y, point.y), std::max(maxCorner.z, point.z));
+    }
+    glm::vec3 extent = maxCorner - minCorner;
+
+    // every vertex snaps to the first vertex seen in its grid cell;
+    // triangles whose corners collapse into the same cell disappear.
+    // crude next to a quadric-error decimator, but it runs at bake time
+    // in one pass and never touches the vertex buffer
+    std::unordered_map<uint64_t, unsigned int> representatives;
+    std::vector<unsigned int> remap(vertexCount);
+
+    for (size_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+        glm::vec3 point = positionAt(vertex);
+        uint64_t cx = 0, cy = 0, cz = 0;
+        if (extent.x > 0.0f) cx = (uint64_t)std::min((float)(gridResolution - 1), (point.x - minCorner.x) / extent.x * gridResolution);
+        if (extent.y > 0.0f) cy = (uint64_t)std::min((float)(gridResolution - 1), (point.y - minCorner.y) / extent.y * gridResolution);
+        if (extent.z > 0.0f) cz = (uint64_t)std::min((float)(gridResolution - 1), (point.z - minCorner.z) / extent.z * gridResolution);
+
+        uint64_t cell = (cx << 40) | (cy << 20) | cz;
+        auto inserted = representatives.emplace(cell, (unsigned int)vertex);
+        remap[vertex] = inserted.first->second;
+    }
+
+    std::vector<unsigned int> simplified;
+    simplified.reserve(indices.size());
+    for (size_t i = 0; i + 2 < indices.size(); i += 3)
+    {
+        unsigned int a = remap[indices[i]];
+        unsigned int b = remap[indices[i + 1]];
+        unsigned int c = remap[indices[i + 2]];
+        if (a != b && b != c && a != c)
+        {
+            simplified.push_back(a);
+            simplified.push_back(b);
+            simplified.push_back(c);
+        }
+    }
+    return simplified;
+}
+
+// run the decimator repeatedly (halving the grid each level) and pack
+// the streams back to back; ranges[0] is always the full-detail input
+static void buildLodChain(const void* vertexData, size_t vertexDataSize, const VertexLayout& layout,
+                          const std::vector<unsigned int>& indices, int lodCount, GLenum drawMode,
+                          std::vector<unsigned int>& combined,
+                          std::vector<std::pair<unsigned int, unsigned int>>& ranges)
+{
+    combined = indices;
+    ranges.push_back({0, (unsigned int)indices.size()});
+
+    int resolution = 32;
+    size_t previousCount = indices.size();
+    for (int lod = 1; lod < lodCount && drawMode == GL_TRIANGLES; lod++)
+    {
+        std::vector<unsigned int> simplified =
+            Mesh::simplifyIndices(vertexData, vertexDataSize, layout, indices, resolution);
+        resolution = (resolution > 2) ? resolution / 2 : 2;
+
+        // decimation ran out of road -> a shorter chain, not junk levels
+        if (simplified.size() < 3 || simplified.size() >= previousCount)
+        {
+            break;
+        }
+
+        ranges.push_back({(unsigned int)combined.size(), (unsigned int)simplified.size()});
+        combined.insert(combined.end(), simplified.begin(), simplified.end());
+        previousCount = simplified.size();
+    }
+}
+
+Mesh::Mesh(const std::vector<float>& vertices, const std::vector<unsigned int>& indices,
+           int lodCount, GLenum drawMode)
+    : indexcount((unsigned int)indices.size()), drawmode(drawMode)
+{
+    VertexLayout layout = VertexLayout::standard();
+    size_t vertexBytes = vertices.size() * sizeof(float);
+
+    std::vector<unsigned int> combined;
+    std::vector<std::pair<unsigned int, unsigned int>> ranges;
+    buildLodChain(vertices.data(), vertexBytes, layout, indices, lodCount, drawMode,
+                  combined, ranges);
+
+    if (ranges.size() > 1)
+    {
+        for (const auto& range : ranges)
+        {
+            lodRanges.push_back({range.first, range.second});
+        }
+    }
+
+    setupBuffers(vertices.data(), vertexBytes, layout, combined.data(), combined.size(), GL_STATIC_DRAW);
+    computeBounds(vertices.data(), vertexBytes, layout);
+}
+
+unsigned int Mesh::getLodCount() const
+{
+    return lodRanges.empty() ? 1 : (unsigned int)lodRanges.size();
+}
+
+unsigned int Mesh::getLodIndexCount(unsigned int lod) const
+{
+    if (lodRanges.empty())
+    {
+        return indexcount;
+    }
+    if (lod >= lodRanges.size())
+    {
+        lod = (unsigned int)lodRanges.size() - 1;
+    }
+    return lodRanges[lod].count;
+}
+
+unsigned int Mesh::getLodFirstIndex(unsigned int lod) const
+{
+    if (lodRanges.empty())
+    {
+        return 0;
+    }
+    if (lod >= lodRanges.size())
+    {
+        lod = (unsigned int)lodRanges.size() - 1;
+    }
+    return lodRanges[lod].firstIndex;
+}
+
+Mesh::Mesh(const void* vertexData, size_t vertexDataSize, const VertexLayout& layout,
+           const std::vector<unsigned int>& indices, GLenum drawMode)
+    : Mesh(vertexData, vertexDataSize, layout, indices.data(), indices.size(), drawMode)
+{
+}
+
+Mesh::Mesh(const void* vertexData, size_t vertexDataSize, const VertexLayout& layout,
+           const unsigned int* indexData, size_t indexCount, GLenum drawMode)
+    : indexcount(indexCount), drawmode(drawMode)
+{
+    setupBuffers(vertexData, vertexDataSize, layout, indexData, indexCount, GL_STATIC_DRAW);
+    computeBounds(vertexData, vertexDataSize, layout);
+}
+
+void Mesh::computeBounds(const void* vertexData, size_t vertexDataSize, const VertexLayout& layout)
+{
+    // walk the position attribute (location 0) and wrap an AABB around
+    // it, then keep the enclosing sphere for the frustum tests. only the
+    // plain 3-float position format is supported -> everything else just
+    // stays uncullable
+    const VertexLayout::Attribute* position = nullptr;
+    for (const VertexLayout::Attribute& attribute : layout.getAttributes())
+    {
+        if (attribute.location == 0)
+        {
+            position = &attribute;
+            break;
+        }
+    }
+
+    if (position == nullptr || position->type != GL_FLOAT || position->components < 3
+        || vertexData == nullptr || layout.getStride() == 0)
+    {
+        return;
+    }
+
+    glm::vec3 minCorner(0.0f), maxCorner(0.0f);
+    size_t vertexCount = vertexDataSize / layout.getStride();
+
+    for (size_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+        const float* xyz = reinterpret_cast<const float*>(
+            static_cast<const unsigned char*>(vertexData) + vertex * layout.getStride() + position->offset);
+        glm::vec3 point(xyz[0], xyz[1], xyz[2]);
+
+        if (vertex == 0)
+        {
+            minCorner = maxCorner = point;
+            continue;
+        }
+        minCorner = glm::vec3(std::min(minCorner.x, point.x), std::min(minCorner.y, point.y), std::min(minCorner.z, point.z));
+        maxCorner = glm::vec3(std::max(maxCorner.x, point.x), std::max(maxCorner.y, point.y), std::max(maxCorner.z, point.z));
+    }
+
+    if (vertexCount > 0)
+    {
+        boundsCenter = (minCorner + maxCorner) * 0.5f;
+        boundsRadius = glm::length(maxCorner - boundsCenter);
+        boundsValid = true;
+    }
+}
+
+Mesh::Mesh(size_t maxVertices, const VertexLayout& layout,
+           const std::vector<unsigned int>& indices, GLenum drawMode)
+    : indexcount(indices.size()), drawmode(drawMode),
+      dynamic(true), maxVertices(maxVertices), vertexStride(layout.getStride())
+{
+    // three regions worth of empty storage; beginDynamicWrite() rotates
+    // through them so the CPU is never writing where the GPU still reads
+    setupBuffers(nullptr, DYNAMIC_REGIONS * maxVertices * vertexStride, layout,
+                 indices.data(), indices.size(), GL_STREAM_DRAW);
+}
+
+void Mesh::setupBuffers(const void* vertexData, size_t vertexDataSize,
+                        const VertexLayout& layout, const unsigned int* indexData,
+                        size_t indexCount, GLenum usage)
 {
     glGenVertexArrays(1, &VAO);
     glGenBuffers(1, &VBO);
     glGenBuffers(1, &EBO);
 
     // make it actTive
-    glBindVertexArray(VAO);
+    GLStateCache::shared().bindVertexArray(VAO);
 
     // make it the active ARRAY_BUFFER
     glBindBuffer(GL_ARRAY_BUFFER, VBO);
-    // "Pour" the raw vertex data (positions, colors, texcoords) into the VBO container
-    glBufferData(GL_ARRAY_BUFFER, vertices.size() * sizeof(float), static_cast<const void*>(vertices.data()), GL_STATIC_DRAW);
-    
+    // "Pour" the raw vertex data into the VBO container
+    glBufferData(GL_ARRAY_BUFFER, vertexDataSize, vertexData, usage);
+
     // "Select" the "Index List" (EBO) - make it the active ELEMENT_ARRAY_BUFFER
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
     // "Write down" the index order into the EBO Index List
-    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indices.size() * sizeof(unsigned int), static_cast<const void*>(indices.data()), GL_STATIC_DRAW);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(unsigned int), static_cast<const void*>(indexData), GL_STATIC_DRAW);
 
-    // --- Tell OpenGL how to read the vertex data from the VBO based on the VAO's "recipe" ---
+    // --- Tell OpenGL how to read the vertex data, one call per attribute
+    // in the layout. packed integer types (normalized ubyte colors, half
+    // float uvs, 2_10_10_10 normals) go through the exact same path ---
+    for (const VertexLayout::Attribute& attribute : layout.getAttributes())
+    {
+        glVertexAttribPointer(attribute.location, attribute.components, attribute.type,
+                              attribute.normalized ? GL_TRUE : GL_FALSE,
+                              layout.getStride(), (void*)(uintptr_t)attribute.offset);
+        glEnableVertexAttribArray(attribute.location);
+    }
 
-    // (0,1,2) - > position , color, texcoord
-    // (3,3,2) - > 3 floats for position, 3 floats for color, 2 floats for texcoord
-    // 8 floats in total (3+3+2)
-    // 8 * sizeof(float) - > jump 8 floats to get to the next vertex data
-    // void* 0 - > start from the beginning of the vertex data
-    // void* 3*sizeof(float) - > start from the 4th float (3rd index) of the vertex data
-    // void* 6*sizeof(float) - > start from the 7th float (6th index) of the vertex data
+    glBindBuffer(GL_ARRAY_BUFFER, 0);         // Deselect VBO as ARRAY_BUFFER
+    GLStateCache::shared().bindVertexArray(0);  // Deselect VAO
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); // Deselect EBO as ELEMENT_ARRAY_BUFFER
+}
 
-    glVertexAttribPointer(0, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)0);
-    glEnableVertexAttribArray(0);
+// ---- .glms mesh container ------------------------------------------------
+// layout (little endian):
+//   char[4]  "GLMS"
+//   uint32   version (2), drawMode, attributeCount
+//   per attribute: uint32 location, int32 components, uint32 type, uint32 normalized
+//   uint64   vertexDataSize (bytes), uint64 indexCount
+//   v2 only: uint32 lodCount, per lod: uint32 firstIndex, uint32 count
+//   vertex blob (already in final GPU layout), then uint32 indices (all
+//   LOD streams back to back; v1 files are one implicit full range)
 
-    glVertexAttribPointer(1, 3, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)(3 * sizeof(float)));
-    glEnableVertexAttribArray(1);
+static const char GLMS_MAGIC[4] = {'G', 'L', 'M', 'S'};
+static const unsigned int GLMS_VERSION = 2;
 
-    glVertexAttribPointer(2, 2, GL_FLOAT, GL_FALSE, 8 * sizeof(float), (void *)(6 * sizeof(float)));
-    glEnableVertexAttribArray(2);
+bool Mesh::writeFile(const char* path, const void* vertexData, size_t vertexDataSize,
+                     const VertexLayout& layout, const std::vector<unsigned int>& indices,
+                     GLenum drawMode, int lodCount)
+{
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "ERROR::MESH::FILE_NOT_WRITABLE: " << path << std::endl;
+        return false;
+    }
 
-    glBindBuffer(GL_ARRAY_BUFFER, 0);         // Deselect VBO as ARRAY_BUFFER
-    glBindVertexArray(0);                     // Deselect VAO
-    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0); // Deselect EBO as ELEMENT_ARRAY_BUFFER
+    // the simplification pass runs here, at bake time -- runtime only
+    // ever reads ranges
+    std::vector<unsigned int> combined;
+    std::vector<std::pair<unsigned int, unsigned int>> ranges;
+    buildLodChain(vertexData, vertexDataSize, layout, indices, lodCount, drawMode,
+                  combined, ranges);
+
+    unsigned int mode = drawMode;
+    unsigned int attributeCount = (unsigned int)layout.getAttributes().size();
+    uint64_t vertexBytes = vertexDataSize;
+    uint64_t indexCount = combined.size();
+    unsigned int rangeCount = (unsigned int)ranges.size();
+
+    file.write(GLMS_MAGIC, 4);
+    file.write(reinterpret_cast<const char*>(&GLMS_VERSION), 4);
+    file.write(reinterpret_cast<const char*>(&mode), 4);
+    file.write(reinterpret_cast<const char*>(&attributeCount), 4);
+
+    for (const VertexLayout::Attribute& attribute : layout.getAttributes())
+    {
+        unsigned int type = attribute.type;
+        unsigned int normalized = attribute.normalized ? 1 : 0;
+        file.write(reinterpret_cast<const char*>(&attribute.location), 4);
+        file.write(reinterpret_cast<const char*>(&attribute.components), 4);
+        file.write(reinterpret_cast<const char*>(&type), 4);
+        file.write(reinterpret_cast<const char*>(&normalized), 4);
+    }
+
+    file.write(reinterpret_cast<const char*>(&vertexBytes), 8);
+    file.write(reinterpret_cast<const char*>(&indexCount), 8);
+
+    file.write(reinterpret_cast<const char*>(&rangeCount), 4);
+    for (const auto& range : ranges)
+    {
+        file.write(reinterpret_cast<const char*>(&range.first), 4);
+        file.write(reinterpret_cast<const char*>(&range.second), 4);
+    }
+
+    file.write(reinterpret_cast<const char*>(vertexData), vertexBytes);
+    file.write(reinterpret_cast<const char*>(combined.data()), indexCount * sizeof(unsigned int));
+
+    return file.good();
+}
+
+Mesh Mesh::fromFile(const char* path)
+{
+    int fd = open(path, O_RDONLY);
+    struct stat fileInfo;
+
+    if (fd < 0 || fstat(fd, &fileInfo) != 0)
+    {
+        std::cerr << "ERROR::MESH::FILE_NOT_READABLE: " << path << std::endl;
+        if (fd >= 0) close(fd);
+        return Mesh(nullptr, 0, VertexLayout::standard(), nullptr, 0, GL_TRIANGLES);
+    }
+
+    // map the whole file: glBufferData reads the blobs directly out of
+    // the mapping, so there is no parse step and no intermediate copy
+    const unsigned char* base = (const unsigned char*)mmap(nullptr, fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+
+    if (base == MAP_FAILED)
+    {
+        std::cerr << "ERROR::MESH::MMAP_FAILED: " << path << std::endl;
+        return Mesh(nullptr, 0, VertexLayout::standard(), nullptr, 0, GL_TRIANGLES);
+    }
+
+    const unsigned char* cursor = base;
+    const unsigned char* end = base + fileInfo.st_size;
+
+    unsigned int version = 0, mode = 0, attributeCount = 0;
+    bool ok = (size_t)fileInfo.st_size >= 16 && std::memcmp(cursor, GLMS_MAGIC, 4) == 0;
+    cursor += 4;
+    std::memcpy(&version, cursor, 4); cursor += 4;
+    std::memcpy(&mode, cursor, 4); cursor += 4;
+    std::memcpy(&attributeCount, cursor, 4); cursor += 4;
+    ok = ok && (version == 1 || version == GLMS_VERSION) && attributeCount > 0 && attributeCount <= 16;
+
+    VertexLayout layout;
+    for (unsigned int i = 0; ok && i < attributeCount; i++)
+    {
+        if (cursor + 16 > end)
+        {
+            ok = false;
+            break;
+        }
+        unsigned int location, type, normalized;
+        int components;
+        std::memcpy(&location, cursor, 4); cursor += 4;
+        std::memcpy(&components, cursor, 4); cursor += 4;
+        std::memcpy(&type, cursor, 4); cursor += 4;
+        std::memcpy(&normalized, cursor, 4); cursor += 4;
+        layout.add(location, components, type, normalized != 0);
+    }
+
+    uint64_t vertexBytes = 0, indexCount = 0;
+    ok = ok && cursor + 16 <= end;
+    if (ok)
+    {
+        std::memcpy(&vertexBytes, cursor, 8); cursor += 8;
+        std::memcpy(&indexCount, cursor, 8); cursor += 8;
+    }
+
+    // v2 carries the baked LOD range table; v1 is one implicit range
+    std::vector<LodRange> ranges;
+    if (ok && version >= 2)
+    {
+        unsigned int rangeCount = 0;
+        ok = cursor + 4 <= end;
+        if (ok)
+        {
+            std::memcpy(&rangeCount, cursor, 4); cursor += 4;
+            ok = rangeCount >= 1 && rangeCount <= 16 && cursor + rangeCount * 8 <= end;
+        }
+        for (unsigned int i = 0; ok && i < rangeCount; i++)
+        {
+            LodRange range;
+            std::memcpy(&range.firstIndex, cursor, 4); cursor += 4;
+            std::memcpy(&range.count, cursor, 4); cursor += 4;
+            ok = (uint64_t)range.firstIndex + range.count <= indexCount;
+            ranges.push_back(range);
+        }
+    }
+
+    // compare sizes, never pointers: adding a corrupt 64-bit vertexBytes
+    // to the cursor (or overflowing indexCount * 4) can wrap the pointer
+    // and sail straight past a `<= end` check
+    ok = ok && vertexBytes <= (uint64_t)(end - cursor)
+            && indexCount <= ((uint64_t)(end - cursor) - vertexBytes) / sizeof(unsigned int);
+
+    if (!ok)
+    {
+        std::cerr << "ERROR::MESH::MALFORMED_FILE: " << path << std::endl;
+        munmap((void*)base, fileInfo.st_size);
+        return Mesh(nullptr, 0, VertexLayout::standard(), nullptr, 0, GL_TRIANGLES);
+    }
+
+    const void* vertexData = cursor;
+    const unsigned int* indexData = reinterpret_cast<const unsigned int*>(cursor + vertexBytes);
+
+    // unmaps AFTER the return value is built (glBufferData has copied the
+    // blobs into driver memory by then)
+    struct Unmapper {
+        void* base; size_t size;
+        ~Unmapper() { munmap(base, size); }
+    } unmapper{(void*)base, (size_t)fileInfo.st_size};
+
+    Mesh mesh(vertexData, (size_t)vertexBytes, layout, indexData, (size_t)indexCount, (GLenum)mode);
+    if (ranges.size() > 1)
+    {
+        mesh.lodRanges = ranges;
+        mesh.indexcount = ranges[0].count; // full detail, not the concatenation
+    }
+    return mesh;
+}
+// --------------------------------------------------------------------------
+
+void Mesh::setupInstanceBuffer(size_t maxInstanceCount)
+{
+    if (instanceVBO != 0)
+    {
+        return; // already set up
+    }
+
+    maxInstances = maxInstanceCount;
+
+    GLStateCache::shared().bindVertexArray(VAO);
+    glGenBuffers(1, &instanceVBO);
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    glBufferData(GL_ARRAY_BUFFER, maxInstances * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+
+    // a mat4 attribute is really four vec4 slots (locations 3..6), each
+    // advancing once per INSTANCE instead of once per vertex
+    for (unsigned int column = 0; column < 4; column++)
+    {
+        glVertexAttribPointer(3 + column, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                              (void*)(uintptr_t)(column * 4 * sizeof(float)));
+        glEnableVertexAttribArray(3 + column);
+        glVertexAttribDivisor(3 + column, 1);
+    }
+
+    // per-instance color at location 7
+    glVertexAttribPointer(7, 4, GL_FLOAT, GL_FALSE, sizeof(InstanceData),
+                          (void*)(uintptr_t)offsetof(InstanceData, color));
+    glEnableVertexAttribArray(7);
+    glVertexAttribDivisor(7, 1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLStateCache::shared().bindVertexArray(0);
+}
+
+void Mesh::updateInstances(const InstanceData* data, size_t count) const
+{
+    if (instanceVBO == 0)
+    {
+        std::cerr << "ERROR::MESH::NO_INSTANCE_BUFFER" << std::endl;
+        return;
+    }
+
+    if (count > maxInstances)
+    {
+        std::cerr << "ERROR::MESH::INSTANCE_OVERFLOW: " << count << " > " << maxInstances << std::endl;
+        count = maxInstances;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, instanceVBO);
+    // orphan first so the copy never stalls on instances still being drawn
+    glBufferData(GL_ARRAY_BUFFER, maxInstances * sizeof(InstanceData), nullptr, GL_STREAM_DRAW);
+    glBufferSubData(GL_ARRAY_BUFFER, 0, count * sizeof(InstanceData), data);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+void Mesh::drawInstanced(size_t count) const
+{
+    glDrawElementsInstanced(drawmode, indexcount, GL_UNSIGNED_INT, 0, (GLsizei)count);
+}
+
+void* Mesh::beginDynamicWrite()
+{
+    if (!dynamic)
+    {
+        std::cerr << "ERROR::MESH::DYNAMIC_WRITE_ON_STATIC_MESH" << std::endl;
+        return nullptr;
+    }
+
+    // fence off the region we just drew from (last frame's draws are in
+    // the command queue by now), then rotate to the oldest region
+    if (regionFence[currentRegion] != nullptr)
+    {
+        glDeleteSync(regionFence[currentRegion]);
+    }
+    regionFence[currentRegion] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+
+    currentRegion = (currentRegion + 1) % DYNAMIC_REGIONS;
+
+    // with three regions this wait almost never actually blocks -> it only
+    // fires when the GPU is more than two full frames behind
+    if (regionFence[currentRegion] != nullptr)
+    {
+        glClientWaitSync(regionFence[currentRegion], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+        glDeleteSync(regionFence[currentRegion]);
+        regionFence[currentRegion] = nullptr;
+    }
+
+    size_t regionBytes = maxVertices * vertexStride;
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+
+    // unsynchronized is safe here because the fence above proved the GPU
+    // is done with this region (persistent mapping would make this map a
+    // no-op, but that needs GL 4.4 and our loader stops at 3.3)
+    return glMapBufferRange(GL_ARRAY_BUFFER, currentRegion * regionBytes, regionBytes,
+                            GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_RANGE_BIT | GL_MAP_UNSYNCHRONIZED_BIT);
+}
+
+void Mesh::endDynamicWrite(unsigned int verticesWritten, unsigned int indicesToDraw)
+{
+    if (!dynamic)
+    {
+        return;
+    }
+
+    if (verticesWritten > maxVertices)
+    {
+        std::cerr << "ERROR::MESH::DYNAMIC_WRITE_OVERFLOW: " << verticesWritten
+                  << " > " << maxVertices << std::endl;
+    }
+
+    glUnmapBuffer(GL_ARRAY_BUFFER);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    indexcount = indicesToDraw;
+}
+
+int Mesh::getBaseVertex() const
+{
+    return dynamic ? (int)(currentRegion * maxVertices) : 0;
 }
 
 void Mesh::bind_VAO() const
 {
     // make it active
-    glBindVertexArray(VAO);
+    GLStateCache::shared().bindVertexArray(VAO);
 }
 
 void Mesh::unbind_VAO() const
 {
     //make it inactive
-    glBindVertexArray(0);
+    GLStateCache::shared().bindVertexArray(0);
 
 }
 
@@ -62,9 +661,69 @@ unsigned int Mesh::getIndexCount() const
     return indexcount;
 }
 
+unsigned int Mesh::getVAO() const
+{
+    return VAO;
+}
+
+GLenum Mesh::getDrawMode() const
+{
+    return drawmode;
+}
+
 Mesh::~Mesh()
 {
+    // drop any per-mesh renderer state before the address can be reused
+    Renderer::onMeshDestroyed(this);
+
+    for (int i = 0; i < DYNAMIC_REGIONS; i++)
+    {
+        if (regionFence[i] != nullptr)
+        {
+            glDeleteSync(regionFence[i]);
+        }
+    }
+
+    if (instanceVBO != 0)
+    {
+        glDeleteBuffers(1, &instanceVBO);
+    }
+
     glDeleteVertexArrays(1, &VAO);
+    GLStateCache::shared().onVertexArrayDeleted(VAO);
     glDeleteBuffers(1, &VBO);
     glDeleteBuffers(1, &EBO);
+}
+
+Mesh::Mesh(Mesh&& other) noexcept
+    : VAO(other.VAO), VBO(other.VBO), EBO(other.EBO), indexcount(other.indexcount),
+      drawmode(other.drawmode), lodRanges(std::move(other.lodRanges)),
+      instanceVBO(other.instanceVBO), maxInstances(other.maxInstances),
+      boundsValid(other.boundsValid), boundsCenter(other.boundsCenter), boundsRadius(other.boundsRadius),
+      dynamic(other.dynamic), maxVertices(other.maxVertices), vertexStride(other.vertexStride),
+      currentRegion(other.currentRegion)
+{
+    for (int i = 0; i < DYNAMIC_REGIONS; i++)
+    {
+        regionFence[i] = other.regionFence[i];
+        other.regionFence[i] = nullptr;
+    }
+
+    // leave the source with nothing to delete (glDelete* of id 0 is a
+    // no-op, so its destructor is then harmless)
+    other.VAO = other.VBO = other.EBO = other.instanceVBO = 0;
+
+    // renderer state keyed on the old address follows the mesh
+    Renderer::onMeshMoved(&other, this);
+}
+
+Mesh& Mesh::operator=(Mesh&& other) noexcept
+{
+    if (this != &other)
+    {
+        // release what we hold, then steal everything from the source
+        this->~Mesh();
+        new (this) Mesh(std::move(other));
+    }
+    return *this;
 }
\ No newline at end of file
@@ -0,0 +1,161 @@
+#include <Profiler.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+
+// enough history for a few seconds of frames without growing forever
+static const size_t MAX_SAMPLES = 4096;
+
+Profiler::~Profiler() {
+    for (const GpuQuery& query : inFlight) {
+        glDeleteQueries(1, &query.beginQuery);
+        glDeleteQueries(1, &query.endQuery);
+    }
+    if (!queryPool.empty()) {
+        glDeleteQueries((GLsizei)queryPool.size(), queryPool.data());
+    }
+}
+
+void Profiler::beginFrame() {
+    frameStart = std::chrono::steady_clock::now();
+    frameOpen = true;
+}
+
+void Profiler::endFrame() {
+    if (frameOpen) {
+        auto elapsed = std::chrono::steady_clock::now() - frameStart;
+        recordSample("frame", std::chrono::duration<float, std::milli>(elapsed).count());
+        frameOpen = false;
+    }
+
+    // harvest from the front of the ring, but ONLY what is already done --
+    // asking for an unfinished result would stall the whole pipeline.
+    // results typically land here one frame after they were issued
+    while (!inFlight.empty()) {
+        GpuQuery& query = inFlight.front();
+
+        GLuint available = 0;
+        glGetQueryObjectuiv(query.endQuery, GL_QUERY_RESULT_AVAILABLE, &available);
+        if (!available) {
+            break;
+        }
+
+        GLuint64 beginTime = 0, endTime = 0;
+        glGetQueryObjectui64v(query.beginQuery, GL_QUERY_RESULT, &beginTime);
+        glGetQueryObjectui64v(query.endQuery, GL_QUERY_RESULT, &endTime);
+
+        recordSample(query.name + " (gpu)", (endTime - beginTime) * 1e-6f);
+
+        queryPool.push_back(query.beginQuery);
+        queryPool.push_back(query.endQuery);
+        inFlight.pop_front();
+    }
+}
+
+unsigned int Profiler::allocQuery() {
+    if (!queryPool.empty()) {
+        unsigned int query = queryPool.back();
+        queryPool.pop_back();
+        return query;
+    }
+    unsigned int query = 0;
+    glGenQueries(1, &query);
+    return query;
+}
+
+void Profiler::beginGpu(const std::string &name) {
+    pending.name = name;
+    pending.beginQuery = allocQuery();
+    glQueryCounter(pending.beginQuery, GL_TIMESTAMP);
+}
+
+void Profiler::endGpu() {
+    pending.endQuery = allocQuery();
+    glQueryCounter(pending.endQuery, GL_TIMESTAMP);
+    inFlight.push_back(pending);
+    pending = GpuQuery();
+}
+
+void Profiler::recordSample(const std::string &name, float milliseconds) {
+    Stage& stage = stages[name];
+    if (stage.samples.size() < MAX_SAMPLES) {
+        stage.samples.push_back(milliseconds);
+    } else {
+        stage.samples[stage.cursor] = milliseconds;
+        stage.cursor = (stage.cursor + 1) % MAX_SAMPLES;
+    }
+}
+
+float Profiler::lastMs(const std::string &name) const {
+    auto it = stages.find(name);
+    if (it == stages.end() || it->second.samples.empty()) {
+        return 0.0f;
+    }
+
+    const Stage& stage = it->second;
+    if (stage.samples.size() < MAX_SAMPLES) {
+        // still growing: push_back order, newest is at the end
+        return stage.samples.back();
+    }
+    // ring is full: cursor points at the next slot to overwrite, so the
+    // newest sample sits right behind it
+    return stage.samples[(stage.cursor + MAX_SAMPLES - 1) % MAX_SAMPLES];
+}
+
+// avg + percentiles from one stage's sample ring
+static void stageNumbers(const std::vector<float>& samples,
+                         float& avg, float& p50, float& p95, float& p99)
+{
+    std::vector<float> sorted = samples;
+    std::sort(sorted.begin(), sorted.end());
+
+    float sum = 0.0f;
+    for (float sample : sorted) {
+        sum += sample;
+    }
+    avg = sum / sorted.size();
+
+    p50 = sorted[sorted.size() * 50 / 100];
+    p95 = sorted[sorted.size() * 95 / 100];
+    p99 = sorted[sorted.size() * 99 / 100];
+}
+
+void Profiler::printSummary() const {
+    std::cout << "---- profiler (ms) ----" << std::endl;
+    for (const auto& [name, stage] : stages) {
+        if (stage.samples.empty()) {
+            continue;
+        }
+
+        float avg, p50, p95, p99;
+        stageNumbers(stage.samples, avg, p50, p95, p99);
+
+        std::cout << std::fixed << std::setprecision(3)
+                  << "  " << std::left << std::setw(20) << name
+                  << " avg " << avg << "  p50 " << p50
+                  << "  p95 " << p95 << "  p99 " << p99 << std::endl;
+    }
+}
+
+void Profiler::writeCSV(const std::string &path) const {
+    std::ofstream file(path, std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::PROFILER::CSV_NOT_WRITABLE: " << path << std::endl;
+        return;
+    }
+
+    file << "stage,samples,avg_ms,p50_ms,p95_ms,p99_ms\n";
+    for (const auto& [name, stage] : stages) {
+        if (stage.samples.empty()) {
+            continue;
+        }
+
+        float avg, p50, p95, p99;
+        stageNumbers(stage.samples, avg, p50, p95, p99);
+
+        file << name << "," << stage.samples.size() << ","
+             << avg << "," << p50 << "," << p95 << "," << p99 << "\n";
+    }
+}
@@ -0,0 +1,414 @@
+#include <RenderGraph.h>
+
+#include <algorithm>
+#include <iostream>
+
+#include "GLStateCache.h"
+
+const RenderGraph::ResourceId RenderGraph::BACKBUFFER;
+
+RenderGraph::ResourceId RenderGraph::createAttachment(const std::string& name,
+                                                      int width, int height, GLenum format)
+{
+    Attachment attachment;
+    attachment.name = name;
+    attachment.width = width;
+    attachment.height = height;
+    attachment.format = format;
+    attachments.push_back(attachment);
+    return (ResourceId)(attachments.size() - 1);
+}
+
+void RenderGraph::addPass(const std::string& name,
+                          std::vector<ResourceId> reads,
+                          std::vector<ResourceId> writes,
+                          std::function<void()> execute)
+{
+    Pass pass;
+    pass.name = name;
+    pass.reads = std::move(reads);
+    pass.writes = std::move(writes);
+    pass.run = std::move(execute);
+    passes.push_back(std::move(pass));
+}
+
+void RenderGraph::reset()
+{
+    passes.clear();
+    schedule.clear();
+}
+
+// ---- compile -------------------------------------------------------------
+
+void RenderGraph::cullPasses()
+{
+    lastCulledPasses = 0;
+
+    // walk backwards from the backbuffer: a pass is live if something
+    // later (and live) reads what it writes. writes to an attachment
+    // nobody consumes this frame cost nothing -- the pass just never runs
+    std::vector<bool> needed(attachments.size(), false);
+
+    for (size_t i = passes.size(); i-- > 0;)
+    {
+        Pass& pass = passes[i];
+
+        pass.live = pass.writes.empty(); // pure side-effect passes always run
+        for (ResourceId write : pass.writes)
+        {
+            if (write == BACKBUFFER || needed[write])
+            {
+                pass.live = true;
+            }
+        }
+
+        if (!pass.live)
+        {
+            lastCulledPasses++;
+            continue;
+        }
+        for (ResourceId read : pass.reads)
+        {
+            if (read != BACKBUFFER)
+            {
+                needed[read] = true;
+            }
+        }
+    }
+}
+
+void RenderGraph::orderPasses()
+{
+    schedule.clear();
+
+    // dependencies come only from the declarations: pass j waits on an
+    // earlier pass i when they touch the same attachment and at least one
+    // of them writes it (read-after-write, write-after-write so the
+    // declared blend order of co-writers holds, and write-after-read)
+    size_t count = passes.size();
+    std::vector<std::vector<size_t>> dependents(count);
+    std::vector<int> pendingDeps(count, 0);
+
+    auto writes = [](const Pass& pass, ResourceId id) {
+        return std::find(pass.writes.begin(), pass.writes.end(), id) != pass.writes.end();
+    };
+    auto touches = [&](const Pass& pass, ResourceId id) {
+        return writes(pass, id) ||
+               std::find(pass.reads.begin(), pass.reads.end(), id) != pass.reads.end();
+    };
+
+    for (size_t j = 0; j < count; j++)
+    {
+        if (!passes[j].live) continue;
+        for (size_t i = 0; i < j; i++)
+        {
+            if (!passes[i].live) continue;
+
+            bool conflict = false;
+            for (ResourceId id : passes[j].writes)
+            {
+                if (touches(passes[i], id)) conflict = true;
+            }
+            for (ResourceId id : passes[j].reads)
+            {
+                if (writes(passes[i], id)) conflict = true;
+            }
+            if (conflict)
+            {
+                dependents[i].push_back(j);
+                pendingDeps[j]++;
+            }
+        }
+    }
+
+    // greedy list scheduling: among the passes whose inputs are all
+    // written, prefer one rendering into the same target as whatever just
+    // ran. independent passes thus interleave themselves into runs that
+    // share an FBO instead of ping-ponging in declaration order
+    std::vector<size_t> ready;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (passes[i].live && pendingDeps[i] == 0)
+        {
+            ready.push_back(i);
+        }
+    }
+
+    const std::vector<ResourceId>* lastTarget = nullptr;
+    while (!ready.empty())
+    {
+        size_t pick = 0;
+        if (lastTarget != nullptr)
+        {
+            for (size_t r = 0; r < ready.size(); r++)
+            {
+                if (passes[ready[r]].writes == *lastTarget)
+                {
+                    pick = r;
+                    break;
+                }
+            }
+        }
+
+        size_t next = ready[pick];
+        ready.erase(ready.begin() + pick);
+        schedule.push_back(next);
+        lastTarget = &passes[next].writes;
+
+        for (size_t dependent : dependents[next])
+        {
+            if (--pendingDeps[dependent] == 0)
+            {
+                // keep declaration order among newly ready passes
+                ready.insert(std::upper_bound(ready.begin(), ready.end(), dependent), dependent);
+            }
+        }
+    }
+}
+
+void RenderGraph::aliasAttachments()
+{
+    for (Attachment& attachment : attachments)
+    {
+        attachment.physical = -1;
+        attachment.firstUse = attachment.lastUse = -1;
+    }
+    for (Physical& physical : physicals)
+    {
+        physical.availableAfter = -1; // free from the top of the frame
+    }
+
+    // lifetime = span of schedule slots that touch the attachment
+    for (size_t slot = 0; slot < schedule.size(); slot++)
+    {
+        const Pass& pass = passes[schedule[slot]];
+        auto touch = [&](ResourceId id) {
+            if (id == BACKBUFFER) return;
+            Attachment& attachment = attachments[id];
+            if (attachment.firstUse < 0) attachment.firstUse = (int)slot;
+            attachment.lastUse = (int)slot;
+        };
+        for (ResourceId id : pass.reads) touch(id);
+        for (ResourceId id : pass.writes) touch(id);
+    }
+
+    // assign physical memory in order of first use; an attachment whose
+    // lifetime starts after another's ended can reuse its GL object if
+    // size and format match, so N ping-pong targets cost far fewer than
+    // N allocations
+    std::vector<size_t> byFirstUse;
+    for (size_t i = 0; i < attachments.size(); i++)
+    {
+        if (attachments[i].firstUse >= 0)
+        {
+            byFirstUse.push_back(i);
+        }
+    }
+    std::sort(byFirstUse.begin(), byFirstUse.end(), [&](size_t a, size_t b) {
+        return attachments[a].firstUse < attachments[b].firstUse;
+    });
+
+    for (size_t index : byFirstUse)
+    {
+        Attachment& attachment = attachments[index];
+        bool isDepth = attachment.format == GL_DEPTH24_STENCIL8;
+
+        for (size_t p = 0; p < physicals.size(); p++)
+        {
+            Physical& physical = physicals[p];
+            if (physical.width == attachment.width && physical.height == attachment.height &&
+                physical.format == attachment.format &&
+                physical.availableAfter < attachment.firstUse)
+            {
+                attachment.physical = (int)p;
+                physical.availableAfter = attachment.lastUse;
+                break;
+            }
+        }
+        if (attachment.physical >= 0)
+        {
+            continue;
+        }
+
+        Physical physical;
+        physical.width = attachment.width;
+        physical.height = attachment.height;
+        physical.format = attachment.format;
+        physical.isDepth = isDepth;
+        physical.availableAfter = attachment.lastUse;
+
+        if (isDepth)
+        {
+            glGenRenderbuffers(1, &physical.id);
+            glBindRenderbuffer(GL_RENDERBUFFER, physical.id);
+            glRenderbufferStorage(GL_RENDERBUFFER, attachment.format,
+                                  attachment.width, attachment.height);
+            glBindRenderbuffer(GL_RENDERBUFFER, 0);
+        }
+        else
+        {
+            glGenTextures(1, &physical.id);
+            // through the state cache, like every other texture bind --
+            // a raw glBindTexture here would leave the cache believing
+            // the previous texture is still bound on the active unit
+            GLStateCache::shared().bindTexture2D(physical.id);
+            glTexImage2D(GL_TEXTURE_2D, 0, attachment.format,
+                         attachment.width, attachment.height, 0,
+                         GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+            glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+            GLStateCache::shared().bindTexture2D(0);
+        }
+
+        attachment.physical = (int)physicals.size();
+        physicals.push_back(physical);
+    }
+}
+
+unsigned int RenderGraph::fboForWrites(const std::vector<ResourceId>& writes)
+{
+    // any backbuffer write means the default framebuffer; mixing it with
+    // offscreen attachments in one pass is not a thing GL can do
+    for (ResourceId id : writes)
+    {
+        if (id == BACKBUFFER)
+        {
+            if (writes.size() > 1)
+            {
+                std::cerr << "ERROR::RENDERGRAPH::BACKBUFFER_MIXED_WITH_ATTACHMENTS" << std::endl;
+            }
+            return 0;
+        }
+    }
+
+    // FBOs are cached on the physical objects, not the logical names, so
+    // aliased attachments that land on the same memory share the FBO too
+    std::vector<int> key;
+    for (ResourceId id : writes)
+    {
+        key.push_back(attachments[id].physical);
+    }
+
+    auto found = fboCache.find(key);
+    if (found != fboCache.end())
+    {
+        return found->second;
+    }
+
+    unsigned int fbo = 0;
+    glGenFramebuffers(1, &fbo);
+    glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+
+    std::vector<GLenum> drawBuffers;
+    for (ResourceId id : writes)
+    {
+        const Physical& physical = physicals[attachments[id].physical];
+        if (physical.isDepth)
+        {
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT,
+                                      GL_RENDERBUFFER, physical.id);
+        }
+        else
+        {
+            GLenum slot = GL_COLOR_ATTACHMENT0 + (GLenum)drawBuffers.size();
+            glFramebufferTexture2D(GL_FRAMEBUFFER, slot, GL_TEXTURE_2D, physical.id, 0);
+            drawBuffers.push_back(slot);
+        }
+    }
+    if (!drawBuffers.empty())
+    {
+        glDrawBuffers((GLsizei)drawBuffers.size(), drawBuffers.data());
+    }
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        std::cerr << "ERROR::RENDERGRAPH::FRAMEBUFFER_INCOMPLETE" << std::endl;
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+
+    fboCache[key] = fbo;
+    return fbo;
+}
+
+// ---- run -----------------------------------------------------------------
+
+void RenderGraph::execute()
+{
+    cullPasses();
+    orderPasses();
+    aliasAttachments();
+
+    lastFboBinds = 0;
+
+    // offscreen passes get a viewport matching their target; put the
+    // caller's back when we return to the default framebuffer
+    GLint callerViewport[4];
+    glGetIntegerv(GL_VIEWPORT, callerViewport);
+
+    unsigned int boundFbo = 0;
+    bool anyBound = false;
+
+    for (size_t index : schedule)
+    {
+        const Pass& pass = passes[index];
+
+        unsigned int fbo = fboForWrites(pass.writes);
+        if (!anyBound || fbo != boundFbo)
+        {
+            glBindFramebuffer(GL_FRAMEBUFFER, fbo);
+            boundFbo = fbo;
+            anyBound = true;
+            lastFboBinds++;
+
+            if (fbo == 0)
+            {
+                glViewport(callerViewport[0], callerViewport[1],
+                           callerViewport[2], callerViewport[3]);
+            }
+            else
+            {
+                const Attachment& first = attachments[pass.writes[0]];
+                glViewport(0, 0, first.width, first.height);
+            }
+        }
+
+        pass.run();
+    }
+
+    if (anyBound && boundFbo != 0)
+    {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glViewport(callerViewport[0], callerViewport[1],
+                   callerViewport[2], callerViewport[3]);
+    }
+}
+
+unsigned int RenderGraph::getAttachmentTexture(ResourceId id) const
+{
+    if (id < 0 || id >= (ResourceId)attachments.size() || attachments[id].physical < 0)
+    {
+        return 0;
+    }
+    return physicals[attachments[id].physical].id;
+}
+
+RenderGraph::~RenderGraph()
+{
+    for (auto& entry : fboCache)
+    {
+        glDeleteFramebuffers(1, &entry.second);
+    }
+    for (Physical& physical : physicals)
+    {
+        if (physical.isDepth)
+        {
+            glDeleteRenderbuffers(1, &physical.id);
+        }
+        else
+        {
+            glDeleteTextures(1, &physical.id);
+        }
+    }
+}
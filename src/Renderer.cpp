@@ -0,0 +1,596 @@
+#include <Renderer.h>
+
+#include <algorithm>
+#include <thread>
+
+#include "FrameArena.h"
+#include "GLStateCache.h"
+#include "JobSystem.h"
+#include "ResidencyManager.h"
+
+#include <glm/gtc/type_ptr.hpp>
+
+std::vector<Renderer*> Renderer::liveRenderers;
+
+Renderer::Renderer()
+{
+    liveRenderers.push_back(this);
+}
+
+Renderer::~Renderer()
+{
+    for (const auto& [mesh, occlusion] : occlusionStates)
+    {
+        if (occlusion.query != 0)
+        {
+            glDeleteQueries(1, &occlusion.query);
+        }
+    }
+
+    liveRenderers.erase(std::remove(liveRenderers.begin(), liveRenderers.end(), this),
+                        liveRenderers.end());
+}
+
+void Renderer::onMeshDestroyed(const Mesh* mesh)
+{
+    for (Renderer* renderer : liveRenderers)
+    {
+        renderer->forgetMesh(mesh);
+    }
+}
+
+void Renderer::onMeshMoved(const Mesh* from, const Mesh* to)
+{
+    for (Renderer* renderer : liveRenderers)
+    {
+        renderer->migrateMesh(from, to);
+    }
+}
+
+void Renderer::forgetMesh(const Mesh* mesh)
+{
+    auto occlusion = occlusionStates.find(mesh);
+    if (occlusion != occlusionStates.end())
+    {
+        // without this a recycled address would inherit a dead mesh's
+        // in-flight query or a stale occluded=true (undrawn for up to
+        // OCCLUSION_RETEST_FRAMES frames)
+        if (occlusion->second.query != 0)
+        {
+            glDeleteQueries(1, &occlusion->second.query);
+        }
+        occlusionStates.erase(occlusion);
+    }
+    lodStates.erase(mesh);
+}
+
+void Renderer::migrateMesh(const Mesh* from, const Mesh* to)
+{
+    auto occlusion = occlusionStates.find(from);
+    if (occlusion != occlusionStates.end())
+    {
+        OcclusionState state = occlusion->second;
+        occlusionStates.erase(occlusion);
+        occlusionStates[to] = state;
+    }
+
+    auto lod = lodStates.find(from);
+    if (lod != lodStates.end())
+    {
+        unsigned int level = lod->second;
+        lodStates.erase(lod);
+        lodStates[to] = level;
+    }
+}
+
+void Renderer::submit(const Mesh& mesh, Shader& shader,
+                      const std::vector<const Texture*>& textures,
+                      const glm::mat4& transform)
+{
+    commands.push_back({&mesh, &shader, textures, transform});
+}
+
+void Renderer::setFrustum(const glm::mat4 &viewProjection)
+{
+    frustum.setFromMatrix(viewProjection);
+    frustumEnabled = true;
+}
+
+void Renderer::clearFrustum()
+{
+    frustumEnabled = false;
+}
+
+void Renderer::setCameraPosition(const glm::vec3 &position)
+{
+    cameraPosition = position;
+}
+
+void Renderer::setOcclusionCullingEnabled(bool enabled)
+{
+    occlusionEnabled = enabled;
+}
+
+void Renderer::setParallelRecordingEnabled(bool enabled)
+{
+    parallelEnabled = enabled;
+}
+
+void Renderer::cullCommands()
+{
+    // gather world-space bounding spheres as SoA so the frustum can test
+    // them four at a time. commands without bounds stay visible. this is
+    // exactly the per-frame scratch the arena exists for -- five heap
+    // vectors per flush used to come and go through malloc
+    size_t count = commands.size();
+    FrameVector<float> centerX(count), centerY(count), centerZ(count), radius(count);
+    FrameVector<unsigned char> visible(count, 1);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const RenderCommand& cmd = commands[i];
+        if (!cmd.mesh->hasBounds())
+        {
+            // mark as trivially inside (radius large enough to pass)
+            centerX[i] = centerY[i] = centerZ[i] = 0.0f;
+            radius[i] = 1e30f;
+            continue;
+        }
+
+        glm::vec4 center = cmd.transform * glm::vec4(cmd.mesh->getBoundsCenter(), 1.0f);
+        centerX[i] = center.x;
+        centerY[i] = center.y;
+        centerZ[i] = center.z;
+
+        // scale the radius by the longest axis of the transform so
+        // non-uniform scaling stays conservative
+        float scale = 0.0f;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            glm::vec3 column(cmd.transform[axis].x, cmd.transform[axis].y, cmd.transform[axis].z);
+            scale = std::max(scale, glm::length(column));
+        }
+        radius[i] = cmd.mesh->getBoundsRadius() * scale;
+    }
+
+    frustum.cullSpheres(centerX.data(), centerY.data(), centerZ.data(),
+                        radius.data(), count, visible.data());
+
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++)
+    {
+        if (visible[i])
+        {
+            if (kept != i)
+            {
+                commands[kept] = std::move(commands[i]);
+            }
+            kept++;
+        }
+        else
+        {
+            // submitted but just off screen -> probably visible soon.
+            // tell the residency manager so its textures stay (or get
+            // promoted back to) full resolution before they show up
+            for (const Texture* texture : commands[i].textures)
+            {
+                ResidencyManager::shared().prefetch(texture);
+            }
+        }
+    }
+    commands.resize(kept);
+}
+
+// ---- parallel recording --------------------------------------------------
+
+// below this many commands the fork/join overhead beats the win and the
+// single-threaded path runs instead
+static const size_t PARALLEL_MIN_COMMANDS = 256;
+
+// the sort key packs shader -> texture -> VAO into one integer, so one
+// compare reproduces the three-way comparator in flush(). 21 bits per
+// field is plenty for GL object names in practice
+static uint64_t encodeSortKey(const RenderCommand& cmd)
+{
+    uint64_t shader = cmd.shader->ID & 0x1FFFFF;
+    uint64_t texture = (cmd.textures.empty() ? 0 : cmd.textures[0]->getID()) & 0x1FFFFF;
+    uint64_t vao = cmd.mesh->getVAO() & 0x1FFFFF;
+    return (shader << 42) | (texture << 21) | vao;
+}
+
+void Renderer::recordShard(size_t shard, size_t begin, size_t end)
+{
+    size_t count = end - begin;
+
+    // same SoA sphere setup as cullCommands, but only for this slice and
+    // with plain local scratch -- the thread-local frame arena belongs to
+    // the render thread and worker arenas would never get reset
+    std::vector<float> centerX(count), centerY(count), centerZ(count), radius(count);
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const RenderCommand& cmd = commands[begin + i];
+        if (!frustumEnabled || !cmd.mesh->hasBounds())
+        {
+            centerX[i] = centerY[i] = centerZ[i] = 0.0f;
+            radius[i] = 1e30f;
+            continue;
+        }
+
+        glm::vec4 center = cmd.transform * glm::vec4(cmd.mesh->getBoundsCenter(), 1.0f);
+        centerX[i] = center.x;
+        centerY[i] = center.y;
+        centerZ[i] = center.z;
+
+        float scale = 0.0f;
+        for (int axis = 0; axis < 3; axis++)
+        {
+            glm::vec3 column(cmd.transform[axis].x, cmd.transform[axis].y, cmd.transform[axis].z);
+            scale = std::max(scale, glm::length(column));
+        }
+        radius[i] = cmd.mesh->getBoundsRadius() * scale;
+    }
+
+    frustum.cullSpheres(centerX.data(), centerY.data(), centerZ.data(),
+                        radius.data(), count, parallelVisible.data() + begin);
+
+    // encode the survivors into this worker's own buffer and sort it.
+    // nobody else touches the buffer, so no locks anywhere
+    std::vector<EncodedDraw>& buffer = shardBuffers[shard];
+    buffer.clear();
+    for (size_t i = 0; i < count; i++)
+    {
+        if (parallelVisible[begin + i])
+        {
+            buffer.push_back({encodeSortKey(commands[begin + i]), (uint32_t)(begin + i)});
+        }
+    }
+
+    std::sort(buffer.begin(), buffer.end(), [](const EncodedDraw& a, const EncodedDraw& b) {
+        if (a.key != b.key) return a.key < b.key;
+        return a.index < b.index; // index tiebreak keeps the sort stable
+    });
+}
+
+void Renderer::recordParallel()
+{
+    size_t count = commands.size();
+
+    unsigned int hardware = std::thread::hardware_concurrency();
+    size_t shardCount = std::max(1u, hardware == 0 ? 1u : hardware - 1);
+    shardCount = std::min(shardCount, count / 64 + 1); // keep shards worth waking a core for
+    shardBuffers.resize(shardCount);
+
+    parallelVisible.assign(count, 1);
+
+    // fork: every worker culls + encodes + sorts its own slice...
+    size_t perShard = (count + shardCount - 1) / shardCount;
+    for (size_t shard = 0; shard < shardCount; shard++)
+    {
+        size_t begin = shard * perShard;
+        size_t end = std::min(begin + perShard, count);
+        JobSystem::shared().submit([this, shard, begin, end] {
+            recordShard(shard, begin, end);
+        });
+    }
+
+    // ...join. this also waits out unrelated jobs in the shared pool
+    // (texture decodes), which is the price of not owning a second pool
+    JobSystem::shared().waitIdle();
+
+    // culled commands still hint the residency manager, but only from
+    // here -- the manager is render-thread-only by design
+    for (size_t i = 0; i < count; i++)
+    {
+        if (!parallelVisible[i])
+        {
+            for (const Texture* texture : commands[i].textures)
+            {
+                ResidencyManager::shared().prefetch(texture);
+            }
+        }
+    }
+
+    // merge the pre-sorted shards into one stream. shard count is tiny,
+    // so a linear scan over the heads beats a heap here
+    mergeScratch.clear();
+    std::vector<size_t> heads(shardCount, 0);
+    while (true)
+    {
+        size_t best = shardCount;
+        for (size_t shard = 0; shard < shardCount; shard++)
+        {
+            if (heads[shard] >= shardBuffers[shard].size())
+            {
+                continue;
+            }
+            if (best == shardCount)
+            {
+                best = shard;
+                continue;
+            }
+            const EncodedDraw& a = shardBuffers[shard][heads[shard]];
+            const EncodedDraw& b = shardBuffers[best][heads[best]];
+            if (a.key < b.key || (a.key == b.key && a.index < b.index))
+            {
+                best = shard;
+            }
+        }
+        if (best == shardCount)
+        {
+            break;
+        }
+        mergeScratch.push_back(std::move(commands[shardBuffers[best][heads[best]].index]));
+        heads[best]++;
+    }
+
+    commands.swap(mergeScratch);
+}
+
+// ---- level of detail -----------------------------------------------------
+
+// a mesh whose bounding sphere subtends less than LOD_BASE_SIZE radians
+// (radius / distance, small-angle) drops to level 1, half that to level 2,
+// and so on. the hysteresis band keeps a mesh hovering right on a
+// threshold from flickering between two levels every frame
+static const float LOD_BASE_SIZE = 0.25f;
+static const float LOD_HYSTERESIS = 0.15f;
+
+static float lodThreshold(unsigned int level)
+{
+    return LOD_BASE_SIZE / (float)(1u << level);
+}
+
+unsigned int Renderer::selectLod(const RenderCommand& cmd)
+{
+    unsigned int levels = cmd.mesh->getLodCount();
+    if (levels <= 1)
+    {
+        return 0;
+    }
+
+    // projected size from the same world-space sphere the culler uses
+    if (!cmd.mesh->hasBounds())
+    {
+        return 0;
+    }
+
+    glm::vec4 center = cmd.transform * glm::vec4(cmd.mesh->getBoundsCenter(), 1.0f);
+    float scale = 0.0f;
+    for (int axis = 0; axis < 3; axis++)
+    {
+        glm::vec3 column(cmd.transform[axis].x, cmd.transform[axis].y, cmd.transform[axis].z);
+        scale = std::max(scale, glm::length(column));
+    }
+    float worldRadius = cmd.mesh->getBoundsRadius() * scale;
+
+    float distance = glm::length(glm::vec3(center.x, center.y, center.z) - cameraPosition);
+    if (distance < 1e-4f)
+    {
+        return 0; // camera inside the mesh -> full detail
+    }
+    float size = worldRadius / distance;
+
+    // start from last frame's choice and only step across a threshold
+    // once the size has cleared it by the hysteresis margin
+    unsigned int current = lodStates[cmd.mesh];
+    if (current >= levels)
+    {
+        current = levels - 1;
+    }
+    while (current + 1 < levels && size < lodThreshold(current + 1) * (1.0f - LOD_HYSTERESIS))
+    {
+        current++;
+    }
+    while (current > 0 && size > lodThreshold(current) * (1.0f + LOD_HYSTERESIS))
+    {
+        current--;
+    }
+
+    lodStates[cmd.mesh] = current;
+    return current;
+}
+
+// meshes that drew zero samples last frame get skipped for a while, then
+// re-tested; fresh query results are harvested without ever blocking
+static const unsigned int OCCLUSION_RETEST_FRAMES = 30;
+
+void Renderer::flush()
+{
+    lastCommands = (unsigned int)commands.size();
+    unsigned int drawCalls = 0;
+
+    if (parallelEnabled && commands.size() >= PARALLEL_MIN_COMMANDS)
+    {
+        // cull + sort on the worker threads, replay the merged stream
+        recordParallel();
+    }
+    else
+    {
+        if (frustumEnabled)
+        {
+            cullCommands();
+        }
+
+        // sort so that draws sharing a shader/texture/VAO end up next to
+        // each other -> the loop below skips the redundant binds entirely
+        std::stable_sort(commands.begin(), commands.end(),
+            [](const RenderCommand& a, const RenderCommand& b) {
+                if (a.shader->ID != b.shader->ID)
+                    return a.shader->ID < b.shader->ID;
+
+                unsigned int texA = a.textures.empty() ? 0 : a.textures[0]->getID();
+                unsigned int texB = b.textures.empty() ? 0 : b.textures[0]->getID();
+                if (texA != texB)
+                    return texA < texB;
+
+                return a.mesh->getVAO() < b.mesh->getVAO();
+            });
+    }
+
+    // what is currently bound (0 = nothing yet)
+    static const unsigned int SHADOW_UNITS = 32;
+    unsigned int boundProgram = 0;
+    unsigned int boundVAO = 0;
+    unsigned int boundTexture[SHADOW_UNITS] = {0}; // one slot per texture unit
+    int instancingState = -1; // what useInstancing is set to on the bound program
+
+    size_t index = 0;
+    while (index < commands.size())
+    {
+        const RenderCommand& cmd = commands[index];
+
+        // after the sort, submissions of the same mesh with the same
+        // shader and textures sit next to each other -> collapse the
+        // whole run into ONE instanced draw when the mesh supports it
+        size_t runEnd = index + 1;
+        if (cmd.mesh->hasInstanceBuffer())
+        {
+            while (runEnd < commands.size()
+                   && commands[runEnd].mesh == cmd.mesh
+                   && commands[runEnd].shader == cmd.shader
+                   && commands[runEnd].textures == cmd.textures)
+            {
+                runEnd++;
+            }
+        }
+        bool instanced = (runEnd - index) > 1;
+
+        OcclusionState* occlusion = nullptr;
+        if (occlusionEnabled && !instanced)
+        {
+            occlusion = &occlusionStates[cmd.mesh];
+
+            // harvest last frame's query if it is done (never block on it)
+            if (occlusion->queryInFlight)
+            {
+                GLuint available = 0;
+                glGetQueryObjectuiv(occlusion->query, GL_QUERY_RESULT_AVAILABLE, &available);
+                if (available)
+                {
+                    GLuint samplesPassed = 0;
+                    glGetQueryObjectuiv(occlusion->query, GL_QUERY_RESULT, &samplesPassed);
+                    occlusion->occluded = (samplesPassed == 0);
+                    occlusion->queryInFlight = false;
+                }
+            }
+
+            if (occlusion->occluded)
+            {
+                if (occlusion->framesSkipped < OCCLUSION_RETEST_FRAMES)
+                {
+                    occlusion->framesSkipped++;
+                    index = runEnd;
+                    continue; // still hidden, skip the draw entirely
+                }
+                // time to re-test -> draw it once and let the query decide
+                occlusion->occluded = false;
+                occlusion->framesSkipped = 0;
+            }
+        }
+
+        if (cmd.shader->ID != boundProgram)
+        {
+            cmd.shader->initialize();
+            boundProgram = cmd.shader->ID;
+            instancingState = -1; // fresh program, flag state unknown
+        }
+
+        for (const Texture* texture : cmd.textures)
+        {
+            // same guard as GLStateCache: a unit past the shadow array
+            // always re-binds instead of indexing out of bounds
+            unsigned int textureUnit = texture->getUnit();
+            if (textureUnit >= SHADOW_UNITS)
+            {
+                texture->bind();
+            }
+            else if (boundTexture[textureUnit] != texture->getID())
+            {
+                texture->bind();
+                boundTexture[textureUnit] = texture->getID();
+            }
+        }
+
+        if (cmd.mesh->getVAO() != boundVAO)
+        {
+            cmd.mesh->bind_VAO();
+            boundVAO = cmd.mesh->getVAO();
+        }
+
+        if (instanced)
+        {
+            // gather the run's transforms into the staging buffer and draw
+            // them all at once (chunked if the run exceeds the buffer)
+            instanceStaging.clear();
+            for (size_t k = index; k < runEnd; k++)
+            {
+                instanceStaging.push_back({commands[k].transform, glm::vec4(1.0f)});
+            }
+
+            if (instancingState != 1)
+            {
+                cmd.shader->setBool("useInstancing", true);
+                instancingState = 1;
+            }
+
+            size_t offset = 0;
+            while (offset < instanceStaging.size())
+            {
+                size_t chunk = std::min(instanceStaging.size() - offset, cmd.mesh->getMaxInstances());
+                cmd.mesh->updateInstances(instanceStaging.data() + offset, chunk);
+                cmd.mesh->drawInstanced(chunk);
+                drawCalls++;
+                offset += chunk;
+            }
+
+            index = runEnd;
+            continue;
+        }
+
+        if (instancingState != 0)
+        {
+            cmd.shader->setBool("useInstancing", false);
+            instancingState = 0;
+        }
+
+        // per-draw transform still goes through a uniform (cached location)
+        cmd.shader->setMat4("transform", cmd.transform);
+
+        bool wrapInQuery = (occlusion != nullptr) && !occlusion->queryInFlight;
+        if (wrapInQuery)
+        {
+            if (occlusion->query == 0)
+            {
+                glGenQueries(1, &occlusion->query);
+            }
+            glBeginQuery(GL_ANY_SAMPLES_PASSED, occlusion->query);
+        }
+
+        // the LOD pick narrows the draw to one range of the mesh's EBO
+        // (meshes without a baked chain report level 0 over everything).
+        // base vertex offsets the draw into the active region of dynamic
+        // meshes; it is 0 for static ones, which makes this a plain
+        // glDrawElements there
+        unsigned int lod = selectLod(cmd);
+        glDrawElementsBaseVertex(cmd.mesh->getDrawMode(), cmd.mesh->getLodIndexCount(lod),
+                                 GL_UNSIGNED_INT,
+                                 (void*)(uintptr_t)(cmd.mesh->getLodFirstIndex(lod) * sizeof(unsigned int)),
+                                 cmd.mesh->getBaseVertex());
+        drawCalls++;
+
+        if (wrapInQuery)
+        {
+            glEndQuery(GL_ANY_SAMPLES_PASSED);
+            occlusion->queryInFlight = true;
+        }
+
+        index = runEnd;
+    }
+
+    // leave a clean state behind like the old loop did
+    GLStateCache::shared().bindVertexArray(0);
+
+    lastDrawCalls = drawCalls;
+    commands.clear();
+}
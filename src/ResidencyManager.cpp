@@ -0,0 +1,117 @@
+#include <ResidencyManager.h>
+
+#include "Texture.h"
+
+ResidencyManager& ResidencyManager::shared()
+{
+    static ResidencyManager manager;
+    return manager;
+}
+
+void ResidencyManager::add(Texture* texture)
+{
+    Entry entry;
+    entry.texture = texture;
+    entry.lastUsed = frameClock;
+    entries[texture] = entry;
+}
+
+void ResidencyManager::remove(const Texture* texture)
+{
+    auto it = entries.find(texture);
+    if (it == entries.end())
+    {
+        return; // moved-from textures were already re-keyed
+    }
+    residentBytes -= it->second.bytes;
+    entries.erase(it);
+}
+
+void ResidencyManager::onMoved(const Texture* from, Texture* to)
+{
+    auto it = entries.find(from);
+    if (it == entries.end())
+    {
+        return;
+    }
+    Entry entry = it->second;
+    entry.texture = to;
+    entries.erase(it);
+    entries[to] = entry;
+}
+
+void ResidencyManager::updateBytes(const Texture* texture, size_t bytes)
+{
+    auto it = entries.find(texture);
+    if (it == entries.end())
+    {
+        return;
+    }
+    residentBytes = residentBytes - it->second.bytes + bytes;
+    it->second.bytes = bytes;
+}
+
+void ResidencyManager::touch(const Texture* texture)
+{
+    auto it = entries.find(texture);
+    if (it == entries.end())
+    {
+        return;
+    }
+    it->second.lastUsed = frameClock;
+
+    // it is literally being drawn -- get the real pixels back
+    if (it->second.texture->isDemoted())
+    {
+        it->second.texture->promote();
+    }
+}
+
+void ResidencyManager::prefetch(const Texture* texture)
+{
+    // same effect as a bind, without the bind: counts as recently used so
+    // eviction skips it, and a demoted texture starts promoting now
+    touch(texture);
+}
+
+void ResidencyManager::endFrame()
+{
+    // finish promotions whose background decode landed (no-op otherwise)
+    for (auto& [key, entry] : entries)
+    {
+        if (!entry.texture->isResident())
+        {
+            entry.texture->update();
+        }
+    }
+
+    // evict least-recently-used first; textures touched this frame and
+    // already-demoted ones are off limits, so this terminates even when
+    // the working set alone exceeds the budget. the clock must still
+    // read this frame's value here -- advancing it before the loop made
+    // the >= guard unsatisfiable, so just-drawn textures got demoted and
+    // re-promoted on their next bind, thrashing every frame over budget
+    while (budget != 0 && residentBytes > budget)
+    {
+        Entry* oldest = nullptr;
+        for (auto& [key, entry] : entries)
+        {
+            if (entry.texture->isDemoted() || entry.lastUsed >= frameClock)
+            {
+                continue;
+            }
+            if (oldest == nullptr || entry.lastUsed < oldest->lastUsed)
+            {
+                oldest = &entry;
+            }
+        }
+
+        if (oldest == nullptr)
+        {
+            break;
+        }
+        oldest->texture->demote(); // reports its new size via updateBytes
+    }
+
+    frameClock++;
+}
@@ -0,0 +1,72 @@
+#include <Scene.h>
+
+#include <iostream>
+
+int Scene::addNode(int parent)
+{
+    if (parent < NO_PARENT || parent >= (int)parents.size())
+    {
+        // children must come after their parents in the arrays, so a
+        // not-yet-added parent index can never be right; anything below
+        // NO_PARENT would index world[] with a negative value
+        std::cerr << "ERROR::SCENE::BAD_PARENT_INDEX: " << parent << std::endl;
+        parent = NO_PARENT;
+    }
+
+    parents.push_back(parent);
+    local.push_back(glm::mat4(1.0f));
+    world.push_back(parent == NO_PARENT ? glm::mat4(1.0f) : world[parent]);
+    dirty.push_back(0);
+    recomputed.push_back(0);
+
+    return (int)parents.size() - 1;
+}
+
+void Scene::setLocalTransform(int node, const glm::mat4 &transform)
+{
+    local[node] = transform;
+    dirty[node] = 1;
+    anyDirty = true;
+}
+
+void Scene::update()
+{
+    if (!anyDirty)
+    {
+        return;
+    }
+
+    // parents sit at lower indices than their children, so one forward
+    // pass is enough: a node recomputes when its own local changed OR its
+    // parent's world matrix was refreshed earlier in this very pass
+    for (size_t node = 0; node < parents.size(); node++)
+    {
+        int parent = parents[node];
+        bool parentMoved = (parent != NO_PARENT) && recomputed[parent];
+
+        if (dirty[node] || parentMoved)
+        {
+            world[node] = (parent == NO_PARENT) ? local[node] : world[parent] * local[node];
+            recomputed[node] = 1;
+            dirty[node] = 0;
+        }
+        else
+        {
+            recomputed[node] = 0;
+        }
+    }
+
+    // clear the scratch flags for the next pass
+    for (size_t node = 0; node < parents.size(); node++)
+    {
+        recomputed[node] = 0;
+    }
+
+    anyDirty = false;
+}
+
+const glm::mat4& Scene::getWorldTransform(int node)
+{
+    update();
+    return world[node];
+}
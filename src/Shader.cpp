@@ -1,6 +1,78 @@
 #include <Shader.h>
+#include <GLStateCache.h>
 
-Shader::Shader(const char* vertexPath, const char* fragmentPath) {
+#include <GLFW/glfw3.h>
+
+#include <glm/gtc/type_ptr.hpp>
+
+#include <filesystem>
+#include <functional>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "Utils.h"
+
+// ---- ARB_get_program_binary ----------------------------------------------
+// our glad header is generated for plain GL 3.3, so the program binary entry
+// points (core in 4.1) have to be pulled in by hand via glfwGetProcAddress.
+// if the driver does not export them we just compile from source like before.
+
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT_ARB 0x8257
+#define GL_PROGRAM_BINARY_LENGTH_ARB           0x8741
+#define GL_NUM_PROGRAM_BINARY_FORMATS_ARB      0x87FE
+
+typedef void (APIENTRYP PFNGLGETPROGRAMBINARYARBPROC)(GLuint program, GLsizei bufSize, GLsizei *length, GLenum *binaryFormat, void *binary);
+typedef void (APIENTRYP PFNGLPROGRAMBINARYARBPROC)(GLuint program, GLenum binaryFormat, const void *binary, GLsizei length);
+typedef void (APIENTRYP PFNGLPROGRAMPARAMETERIARBPROC)(GLuint program, GLenum pname, GLint value);
+
+static PFNGLGETPROGRAMBINARYARBPROC pfnGetProgramBinary = nullptr;
+static PFNGLPROGRAMBINARYARBPROC pfnProgramBinary = nullptr;
+static PFNGLPROGRAMPARAMETERIARBPROC pfnProgramParameteri = nullptr;
+
+// resolve the entry points once; returns false when the driver has no
+// binary format to offer (then the whole cache is a no-op)
+static bool programBinarySupported() {
+    static bool resolved = false;
+    static bool supported = false;
+
+    if (!resolved) {
+        resolved = true;
+        pfnGetProgramBinary = (PFNGLGETPROGRAMBINARYARBPROC)glfwGetProcAddress("glGetProgramBinary");
+        pfnProgramBinary = (PFNGLPROGRAMBINARYARBPROC)glfwGetProcAddress("glProgramBinary");
+        pfnProgramParameteri = (PFNGLPROGRAMPARAMETERIARBPROC)glfwGetProcAddress("glProgramParameteri");
+
+        int numFormats = 0;
+        if (pfnGetProgramBinary && pfnProgramBinary) {
+            glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS_ARB, &numFormats);
+        }
+        supported = (numFormats > 0);
+    }
+    return supported;
+}
+// --------------------------------------------------------------------------
+
+// GL_KHR_parallel_shader_compile: lets us poll whether a background link
+// finished instead of blocking in glGetProgramiv(GL_LINK_STATUS)
+#define GL_COMPLETION_STATUS_KHR 0x91B1
+
+static bool parallelCompileSupported() {
+    static bool resolved = false;
+    static bool supported = false;
+    if (!resolved) {
+        resolved = true;
+        supported = glfwExtensionSupported("GL_KHR_parallel_shader_compile") == GLFW_TRUE;
+    }
+    return supported;
+}
+
+Shader::Shader(const char* vertexPath, const char* fragmentPath)
+    : vertexPath(vertexPath), fragmentPath(fragmentPath)
+{
+    // remember the mtimes so checkForReload() can spot edits
+    std::error_code ec;
+    vertexTime = std::filesystem::last_write_time(vertexPath, ec);
+    fragmentTime = std::filesystem::last_write_time(fragmentPath, ec);
 
     // getting the file paths of vertex and fragment shaders
     std::string vertexCode;
@@ -28,6 +100,14 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
         std::cerr << "ERROR::SHADER::FILE_NOT_SUCCESFULLY_READ" << std::endl;
     }
 
+    // try the on-disk program binary first -> skips GLSL compilation
+    // entirely when the cache entry matches this source + driver combo
+    std::string cachePath = binaryCachePath(vertexCode, fragmentCode);
+    if (!cachePath.empty() && loadFromBinaryCache(cachePath)) {
+        cacheUniformLocations();
+        return;
+    }
+
     const char* vShaderCode = vertexCode.c_str();
     const char* fShaderCode = fragmentCode.c_str();
 
@@ -73,6 +153,13 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     ID = glCreateProgram();
     glAttachShader(ID, vertexShader);
     glAttachShader(ID, fragmentShader);
+
+    // has to be set before linking or some drivers refuse to hand the
+    // binary back later
+    if (!cachePath.empty() && pfnProgramParameteri) {
+        pfnProgramParameteri(ID, GL_PROGRAM_BINARY_RETRIEVABLE_HINT_ARB, GL_TRUE);
+    }
+
     glLinkProgram(ID);
     glGetProgramiv(ID, GL_LINK_STATUS, &linkersuccess);
 
@@ -85,21 +172,303 @@ Shader::Shader(const char* vertexPath, const char* fragmentPath) {
     glDeleteShader(vertexShader);
     glDeleteShader(fragmentShader);
 
+    // a fresh link is worth remembering for the next run
+    if (!cachePath.empty() && linkersuccess) {
+        storeInBinaryCache(cachePath);
+    }
+
+    // grab every uniform location once so the setters never have to ask
+    // the driver again
+    cacheUniformLocations();
+
+}
+
+Shader::~Shader() {
+    // a reload that never finished still owns its half-built objects
+    if (pendingVertexShader != 0) glDeleteShader(pendingVertexShader);
+    if (pendingFragmentShader != 0) glDeleteShader(pendingFragmentShader);
+    if (pendingProgram != 0) glDeleteProgram(pendingProgram);
+
+    glDeleteProgram(ID); // id 0 is silently ignored
+    GLStateCache::shared().onProgramDeleted(ID);
+}
+
+Shader::Shader(Shader&& other) noexcept
+    : ID(other.ID),
+      uniformLocations(std::move(other.uniformLocations)),
+      blockBindings(std::move(other.blockBindings)),
+      vertexPath(std::move(other.vertexPath)),
+      fragmentPath(std::move(other.fragmentPath)),
+      vertexTime(other.vertexTime), fragmentTime(other.fragmentTime),
+      pendingProgram(other.pendingProgram),
+      pendingVertexShader(other.pendingVertexShader),
+      pendingFragmentShader(other.pendingFragmentShader)
+{
+    other.ID = 0;
+    other.pendingProgram = 0;
+    other.pendingVertexShader = 0;
+    other.pendingFragmentShader = 0;
+}
+
+Shader& Shader::operator=(Shader&& other) noexcept {
+    if (this != &other) {
+        this->~Shader();
+        new (this) Shader(std::move(other));
+    }
+    return *this;
+}
+
+std::string Shader::binaryCachePath(const std::string &vertexCode, const std::string &fragmentCode) const {
+    if (!programBinarySupported()) {
+        return "";
+    }
+
+    // key the entry by source AND driver -> a driver update or edited
+    // shader silently becomes a cache miss instead of a broken program
+    std::string key = vertexCode + fragmentCode;
+    key += reinterpret_cast<const char*>(glGetString(GL_VENDOR));
+    key += reinterpret_cast<const char*>(glGetString(GL_RENDERER));
+    key += reinterpret_cast<const char*>(glGetString(GL_VERSION));
+
+    std::stringstream name;
+    name << std::hex << std::hash<std::string>{}(key) << ".bin";
+
+    std::filesystem::path dir = std::filesystem::path(getExecutableDir()) / "shader_cache";
+    std::error_code ec;
+    std::filesystem::create_directories(dir, ec);
+    if (ec) {
+        return "";
+    }
+
+    return (dir / name.str()).string();
+}
+
+bool Shader::loadFromBinaryCache(const std::string &path) {
+    std::ifstream file(path, std::ios::binary);
+    if (!file.is_open()) {
+        return false;
+    }
+
+    GLenum binaryFormat = 0;
+    file.read(reinterpret_cast<char*>(&binaryFormat), sizeof(binaryFormat));
+
+    std::vector<char> binary((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+    if (!file.good() || binary.empty()) {
+        return false;
+    }
+
+    ID = glCreateProgram();
+    pfnProgramBinary(ID, binaryFormat, binary.data(), (GLsizei)binary.size());
+
+    // the driver is allowed to reject a binary at any time (it may have
+    // been produced by an older blob) -> treat that as a plain miss
+    int linkersuccess = 0;
+    glGetProgramiv(ID, GL_LINK_STATUS, &linkersuccess);
+    if (!linkersuccess) {
+        glDeleteProgram(ID);
+        ID = 0;
+        return false;
+    }
+
+    return true;
+}
+
+void Shader::storeInBinaryCache(const std::string &path) const {
+    int binaryLength = 0;
+    glGetProgramiv(ID, GL_PROGRAM_BINARY_LENGTH_ARB, &binaryLength);
+    if (binaryLength <= 0) {
+        return;
+    }
+
+    std::vector<char> binary(binaryLength);
+    GLenum binaryFormat = 0;
+    GLsizei written = 0;
+    pfnGetProgramBinary(ID, binaryLength, &written, &binaryFormat, binary.data());
+    if (written <= 0) {
+        return;
+    }
+
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "ERROR::SHADER::BINARY_CACHE_NOT_WRITABLE: " << path << std::endl;
+        return;
+    }
+
+    file.write(reinterpret_cast<const char*>(&binaryFormat), sizeof(binaryFormat));
+    file.write(binary.data(), written);
+}
+
+void Shader::cacheUniformLocations() {
+    int uniformCount = 0;
+    glGetProgramiv(ID, GL_ACTIVE_UNIFORMS, &uniformCount);
+
+    char name[256];
+    for (int i = 0; i < uniformCount; i++) {
+        GLsizei nameLength = 0;
+        GLint size = 0;
+        GLenum type = 0;
+        glGetActiveUniform(ID, i, sizeof(name), &nameLength, &size, &type, name);
+
+        // arrays come back as "foo[0]" -> the location of that name is the
+        // start of the array, which is exactly what we want to cache
+        uniformLocations[std::string(name, nameLength)] = glGetUniformLocation(ID, name);
+    }
+}
+
+GLint Shader::getUniformLocation(const std::string &name) const {
+    auto it = uniformLocations.find(name);
+    if (it != uniformLocations.end()) {
+        return it->second;
+    }
 
+    // not seen by the introspection pass (optimized out, or asked before
+    // linking went wrong) -> look it up once and remember it, even if -1
+    GLint location = glGetUniformLocation(ID, name.c_str());
+    uniformLocations[name] = location;
+    return location;
 }
 
 void Shader::initialize() {
-    glUseProgram(ID);
+    // elided by the cache when this program is already current
+    GLStateCache::shared().useProgram(ID);
+}
+
+void Shader::bindUniformBlock(const std::string &blockName, unsigned int bindingPoint) const {
+    GLuint blockIndex = glGetUniformBlockIndex(ID, blockName.c_str());
+    if (blockIndex == GL_INVALID_INDEX) {
+        // not every program uses every shared block -> that's fine
+        return;
+    }
+    glUniformBlockBinding(ID, blockIndex, bindingPoint);
+
+    // remember it -> a hot-reloaded replacement program needs the same wiring
+    blockBindings[blockName] = bindingPoint;
+}
+
+void Shader::checkForReload() {
+    if (pendingProgram != 0) {
+        pollPendingReload();
+        return;
+    }
+
+    std::error_code ec;
+    auto newVertexTime = std::filesystem::last_write_time(vertexPath, ec);
+    if (ec) {
+        return; // editor may have the file half-saved; try again later
+    }
+    auto newFragmentTime = std::filesystem::last_write_time(fragmentPath, ec);
+    if (ec) {
+        return;
+    }
+
+    if (newVertexTime != vertexTime || newFragmentTime != fragmentTime) {
+        vertexTime = newVertexTime;
+        fragmentTime = newFragmentTime;
+        startReload();
+    }
+}
+
+void Shader::startReload() {
+    std::ifstream vShaderFile(vertexPath);
+    std::ifstream fShaderFile(fragmentPath);
+    if (!vShaderFile.is_open() || !fShaderFile.is_open()) {
+        std::cerr << "ERROR::SHADER::RELOAD_FILE_NOT_READABLE" << std::endl;
+        return;
+    }
+
+    std::string vertexCode((std::istreambuf_iterator<char>(vShaderFile)), std::istreambuf_iterator<char>());
+    std::string fragmentCode((std::istreambuf_iterator<char>(fShaderFile)), std::istreambuf_iterator<char>());
+    const char* vShaderCode = vertexCode.c_str();
+    const char* fShaderCode = fragmentCode.c_str();
+
+    // compile + link the REPLACEMENT while the old program keeps
+    // rendering. with GL_KHR_parallel_shader_compile the driver does this
+    // on its own threads and pollPendingReload() just checks in on it
+    pendingVertexShader = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(pendingVertexShader, 1, &vShaderCode, NULL);
+    glCompileShader(pendingVertexShader);
+
+    pendingFragmentShader = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(pendingFragmentShader, 1, &fShaderCode, NULL);
+    glCompileShader(pendingFragmentShader);
+
+    pendingProgram = glCreateProgram();
+    glAttachShader(pendingProgram, pendingVertexShader);
+    glAttachShader(pendingProgram, pendingFragmentShader);
+    glLinkProgram(pendingProgram);
+
+    std::cout << "reloading shader: " << vertexPath << " + " << fragmentPath << std::endl;
+}
+
+void Shader::pollPendingReload() {
+    // without the extension this query blocks once -- still better than
+    // blocking every frame, and the swap logic below is identical
+    if (parallelCompileSupported()) {
+        GLint complete = GL_FALSE;
+        glGetProgramiv(pendingProgram, GL_COMPLETION_STATUS_KHR, &complete);
+        if (!complete) {
+            return; // not done yet, keep rendering the old program
+        }
+    }
+
+    int linkersuccess = 0;
+    glGetProgramiv(pendingProgram, GL_LINK_STATUS, &linkersuccess);
+
+    glDeleteShader(pendingVertexShader);
+    glDeleteShader(pendingFragmentShader);
+    pendingVertexShader = 0;
+    pendingFragmentShader = 0;
+
+    if (!linkersuccess) {
+        char LOG_IF_ERROR[512];
+        glGetProgramInfoLog(pendingProgram, 512, NULL, LOG_IF_ERROR);
+        std::cerr << "ERROR::SHADER::RELOAD_FAILED (keeping old program)\n" << LOG_IF_ERROR << std::endl;
+        glDeleteProgram(pendingProgram);
+        pendingProgram = 0;
+        return;
+    }
+
+    // atomic swap: everything rendered after this line uses the new code.
+    // the cache must forget the dead name too -- the next glCreateProgram
+    // (often the next reload) can recycle it, and an elided useProgram on
+    // the recycled id would keep the wrong program bound
+    glDeleteProgram(ID);
+    GLStateCache::shared().onProgramDeleted(ID);
+    ID = pendingProgram;
+    pendingProgram = 0;
+
+    uniformLocations.clear();
+    cacheUniformLocations();
+    for (const auto& [blockName, bindingPoint] : blockBindings) {
+        GLuint blockIndex = glGetUniformBlockIndex(ID, blockName.c_str());
+        if (blockIndex != GL_INVALID_INDEX) {
+            glUniformBlockBinding(ID, blockIndex, bindingPoint);
+        }
+    }
+
+    std::cout << "shader reloaded" << std::endl;
 }
 
 void Shader::setBool(const std::string &name, bool value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), (int)value);
+    glUniform1i(getUniformLocation(name), (int)value);
 }
 
 void Shader::setInt(const std::string &name, int value) const {
-    glUniform1i(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1i(getUniformLocation(name), value);
 }
 
 void Shader::setFloat(const std::string &name, float value) const {
-    glUniform1f(glGetUniformLocation(ID, name.c_str()), value);
+    glUniform1f(getUniformLocation(name), value);
+}
+
+void Shader::setVec2(const std::string &name, const glm::vec2 &value) const {
+    glUniform2fv(getUniformLocation(name), 1, glm::value_ptr(value));
+}
+
+void Shader::setVec3(const std::string &name, const glm::vec3 &value) const {
+    glUniform3fv(getUniformLocation(name), 1, glm::value_ptr(value));
+}
+
+void Shader::setMat4(const std::string &name, const glm::mat4 &value) const {
+    glUniformMatrix4fv(getUniformLocation(name), 1, GL_FALSE, glm::value_ptr(value));
 }
\ No newline at end of file
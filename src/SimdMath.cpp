@@ -0,0 +1,69 @@
+#include <SimdMath.h>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+// both kernels are the same 3x4 (points) / 3x3 (directions) multiply;
+// `translate` switches the w column on and off
+static void transformStream(const glm::mat4& matrix,
+                            float* xs, float* ys, float* zs, size_t count,
+                            bool translate)
+{
+    // glm is column major: world.x = m[0][0]*x + m[1][0]*y + m[2][0]*z + m[3][0]
+    const float m00 = matrix[0][0], m10 = matrix[1][0], m20 = matrix[2][0], m30 = matrix[3][0];
+    const float m01 = matrix[0][1], m11 = matrix[1][1], m21 = matrix[2][1], m31 = matrix[3][1];
+    const float m02 = matrix[0][2], m12 = matrix[1][2], m22 = matrix[2][2], m32 = matrix[3][2];
+
+    const float tx = translate ? m30 : 0.0f;
+    const float ty = translate ? m31 : 0.0f;
+    const float tz = translate ? m32 : 0.0f;
+
+    size_t i = 0;
+
+#ifdef __SSE2__
+    const __m128 c00 = _mm_set1_ps(m00), c10 = _mm_set1_ps(m10), c20 = _mm_set1_ps(m20);
+    const __m128 c01 = _mm_set1_ps(m01), c11 = _mm_set1_ps(m11), c21 = _mm_set1_ps(m21);
+    const __m128 c02 = _mm_set1_ps(m02), c12 = _mm_set1_ps(m12), c22 = _mm_set1_ps(m22);
+    const __m128 ctx = _mm_set1_ps(tx), cty = _mm_set1_ps(ty), ctz = _mm_set1_ps(tz);
+
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(xs + i);
+        __m128 y = _mm_loadu_ps(ys + i);
+        __m128 z = _mm_loadu_ps(zs + i);
+
+        __m128 outX = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c00, x), _mm_mul_ps(c10, y)),
+                                 _mm_add_ps(_mm_mul_ps(c20, z), ctx));
+        __m128 outY = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c01, x), _mm_mul_ps(c11, y)),
+                                 _mm_add_ps(_mm_mul_ps(c21, z), cty));
+        __m128 outZ = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c02, x), _mm_mul_ps(c12, y)),
+                                 _mm_add_ps(_mm_mul_ps(c22, z), ctz));
+
+        _mm_storeu_ps(xs + i, outX);
+        _mm_storeu_ps(ys + i, outY);
+        _mm_storeu_ps(zs + i, outZ);
+    }
+#endif
+
+    // scalar tail (and the whole stream on non-SSE2 targets)
+    for (; i < count; i++)
+    {
+        float x = xs[i], y = ys[i], z = zs[i];
+        xs[i] = m00 * x + m10 * y + m20 * z + tx;
+        ys[i] = m01 * x + m11 * y + m21 * z + ty;
+        zs[i] = m02 * x + m12 * y + m22 * z + tz;
+    }
+}
+
+void transformPoints(const glm::mat4& matrix,
+                     float* xs, float* ys, float* zs, size_t count)
+{
+    transformStream(matrix, xs, ys, zs, count, true);
+}
+
+void transformDirections(const glm::mat4& matrix,
+                         float* xs, float* ys, float* zs, size_t count)
+{
+    transformStream(matrix, xs, ys, zs, count, false);
+}
@@ -0,0 +1,283 @@
+#include <StaticBatch.h>
+#include <GLStateCache.h>
+
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <iostream>
+#include <new>
+#include <utility>
+
+#include "SimdMath.h"
+#include "VertexFormat.h"
+
+// ---- ARB_multi_draw_indirect ---------------------------------------------
+// core in GL 4.3, so like the program binary entry points in Shader.cpp it
+// has to come in through glfwGetProcAddress. without it, draw() falls back
+// to replaying the command list as glDrawElementsBaseVertex calls -- still
+// one VAO bind and zero state changes for the whole static world.
+
+#define GL_DRAW_INDIRECT_BUFFER 0x8F3F
+
+typedef void (APIENTRYP PFNGLMULTIDRAWELEMENTSINDIRECTPROC)(GLenum mode, GLenum type, const void* indirect, GLsizei drawcount, GLsizei stride);
+
+static PFNGLMULTIDRAWELEMENTSINDIRECTPROC pfnMultiDrawElementsIndirect = nullptr;
+
+static bool multiDrawIndirectSupported()
+{
+    static bool resolved = false;
+    if (!resolved)
+    {
+        resolved = true;
+        if (glfwExtensionSupported("GL_ARB_multi_draw_indirect"))
+        {
+            pfnMultiDrawElementsIndirect = (PFNGLMULTIDRAWELEMENTSINDIRECTPROC)
+                glfwGetProcAddress("glMultiDrawElementsIndirect");
+        }
+    }
+    return pfnMultiDrawElementsIndirect != nullptr;
+}
+
+// floats per vertex in the standard 3 pos + 3 color + 2 uv layout
+static const size_t VERTEX_FLOATS = 8;
+static_assert(VERTEX_FLOATS * sizeof(float) == StandardVertex::stride(),
+              "batch packing math no longer matches the standard vertex layout");
+
+void StaticBatch::add(const std::vector<float>& vertices,
+                      const std::vector<unsigned int>& indices,
+                      const glm::mat4& transform)
+{
+    if (built)
+    {
+        std::cerr << "ERROR::STATICBATCH::ADD_AFTER_BUILD" << std::endl;
+        return;
+    }
+
+    size_t vertexCount = vertices.size() / VERTEX_FLOATS;
+
+    DrawCommand command;
+    command.count = (unsigned int)indices.size();
+    command.instanceCount = 1;
+    command.firstIndex = (unsigned int)mergedIndices.size();
+    command.baseVertex = (unsigned int)(mergedVertices.size() / VERTEX_FLOATS);
+    command.baseInstance = 0;
+    commands.push_back(command);
+
+    // indices stay mesh-relative; baseVertex shifts them at draw time
+    mergedIndices.insert(mergedIndices.end(), indices.begin(), indices.end());
+
+    // bake the transform into the positions: gather them SoA and let the
+    // batch kernel do the matrix math four points at a time (one matrix
+    // over many vertices is exactly its sweet spot)
+    std::vector<float> xs(vertexCount), ys(vertexCount), zs(vertexCount);
+    for (size_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+        const float* source = &vertices[vertex * VERTEX_FLOATS];
+        xs[vertex] = source[0];
+        ys[vertex] = source[1];
+        zs[vertex] = source[2];
+    }
+    transformPoints(transform, xs.data(), ys.data(), zs.data(), vertexCount);
+
+    // write back interleaved (colors and uvs pass through) and grow a
+    // bounding sphere from the transformed points
+    glm::vec3 minCorner(0.0f), maxCorner(0.0f);
+    for (size_t vertex = 0; vertex < vertexCount; vertex++)
+    {
+        const float* source = &vertices[vertex * VERTEX_FLOATS];
+
+        mergedVertices.push_back(xs[vertex]);
+        mergedVertices.push_back(ys[vertex]);
+        mergedVertices.push_back(zs[vertex]);
+        for (size_t component = 3; component < VERTEX_FLOATS; component++)
+        {
+            mergedVertices.push_back(source[component]);
+        }
+
+        glm::vec3 point(xs[vertex], ys[vertex], zs[vertex]);
+        if (vertex == 0)
+        {
+            minCorner = maxCorner = point;
+            continue;
+        }
+        minCorner = glm::vec3(std::min(minCorner.x, point.x), std::min(minCorner.y, point.y), std::min(minCorner.z, point.z));
+        maxCorner = glm::vec3(std::max(maxCorner.x, point.x), std::max(maxCorner.y, point.y), std::max(maxCorner.z, point.z));
+    }
+
+    glm::vec3 center = (minCorner + maxCorner) * 0.5f;
+    centerX.push_back(center.x);
+    centerY.push_back(center.y);
+    centerZ.push_back(center.z);
+    radius.push_back(glm::length(maxCorner - center));
+}
+
+void StaticBatch::build()
+{
+    if (built || commands.empty())
+    {
+        return;
+    }
+
+    glGenVertexArrays(1, &VAO);
+    glGenBuffers(1, &VBO);
+    glGenBuffers(1, &EBO);
+
+    GLStateCache::shared().bindVertexArray(VAO);
+
+    glBindBuffer(GL_ARRAY_BUFFER, VBO);
+    glBufferData(GL_ARRAY_BUFFER, mergedVertices.size() * sizeof(float),
+                 mergedVertices.data(), GL_STATIC_DRAW);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, EBO);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, mergedIndices.size() * sizeof(unsigned int),
+                 mergedIndices.data(), GL_STATIC_DRAW);
+
+    // same attribute setup Mesh uses for the standard layout, but the
+    // whole sequence is compile-time constants now
+    StandardVertex::enableAttributes();
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GLStateCache::shared().bindVertexArray(0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    // the command list lives on the GPU too; DYNAMIC because cull()
+    // rewrites it, potentially every frame
+    glGenBuffers(1, &indirectBuffer);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawCommand),
+                 commands.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+
+    activeCommands = commands;
+    activeCount = (unsigned int)commands.size();
+    visible.resize(commands.size());
+    built = true;
+
+    // the merged copies only existed to fill the buffers
+    mergedVertices.clear();
+    mergedVertices.shrink_to_fit();
+    mergedIndices.clear();
+    mergedIndices.shrink_to_fit();
+}
+
+void StaticBatch::cull(const Frustum& frustum)
+{
+    if (!built)
+    {
+        return;
+    }
+
+    frustum.cullSpheres(centerX.data(), centerY.data(), centerZ.data(),
+                        radius.data(), commands.size(), visible.data());
+
+    activeCommands.clear();
+    for (size_t i = 0; i < commands.size(); i++)
+    {
+        if (visible[i])
+        {
+            activeCommands.push_back(commands[i]);
+        }
+    }
+
+    unsigned int newCount = (unsigned int)activeCommands.size();
+    if (newCount == activeCount && newCount == commands.size())
+    {
+        return; // nothing was ever culled, buffer already matches
+    }
+    activeCount = newCount;
+
+    // rewrite just the command list -- the vertex data never moves.
+    // orphan first so the GPU can still read last frame's commands
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawCommand),
+                 nullptr, GL_DYNAMIC_DRAW);
+    glBufferSubData(GL_DRAW_INDIRECT_BUFFER, 0,
+                    activeCount * sizeof(DrawCommand), activeCommands.data());
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void StaticBatch::resetCull()
+{
+    if (!built || activeCount == commands.size())
+    {
+        return;
+    }
+
+    activeCommands = commands;
+    activeCount = (unsigned int)commands.size();
+
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+    glBufferData(GL_DRAW_INDIRECT_BUFFER, commands.size() * sizeof(DrawCommand),
+                 commands.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+}
+
+void StaticBatch::draw() const
+{
+    if (!built || activeCount == 0)
+    {
+        return;
+    }
+
+    GLStateCache::shared().bindVertexArray(VAO);
+
+    if (multiDrawIndirectSupported())
+    {
+        // the whole static world in ONE driver call
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, indirectBuffer);
+        pfnMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, nullptr,
+                                     (GLsizei)activeCount, 0);
+        glBindBuffer(GL_DRAW_INDIRECT_BUFFER, 0);
+    }
+    else
+    {
+        // pre-4.3 fallback: replay the same commands ourselves. no binds
+        // between draws, so this is still far cheaper than per-mesh VAOs
+        for (unsigned int i = 0; i < activeCount; i++)
+        {
+            const DrawCommand& command = activeCommands[i];
+            glDrawElementsBaseVertex(GL_TRIANGLES, command.count, GL_UNSIGNED_INT,
+                                     (void*)(uintptr_t)(command.firstIndex * sizeof(unsigned int)),
+                                     (GLint)command.baseVertex);
+        }
+    }
+
+    GLStateCache::shared().bindVertexArray(0);
+}
+
+StaticBatch::~StaticBatch()
+{
+    if (indirectBuffer != 0)
+    {
+        glDeleteBuffers(1, &indirectBuffer);
+    }
+    glDeleteVertexArrays(1, &VAO);
+    GLStateCache::shared().onVertexArrayDeleted(VAO);
+    glDeleteBuffers(1, &VBO);
+    glDeleteBuffers(1, &EBO);
+}
+
+StaticBatch::StaticBatch(StaticBatch&& other) noexcept
+    : VAO(other.VAO), VBO(other.VBO), EBO(other.EBO), indirectBuffer(other.indirectBuffer),
+      built(other.built),
+      mergedVertices(std::move(other.mergedVertices)),
+      mergedIndices(std::move(other.mergedIndices)),
+      commands(std::move(other.commands)),
+      activeCommands(std::move(other.activeCommands)),
+      centerX(std::move(other.centerX)), centerY(std::move(other.centerY)),
+      centerZ(std::move(other.centerZ)), radius(std::move(other.radius)),
+      visible(std::move(other.visible)),
+      activeCount(other.activeCount)
+{
+    other.VAO = other.VBO = other.EBO = other.indirectBuffer = 0;
+}
+
+StaticBatch& StaticBatch::operator=(StaticBatch&& other) noexcept
+{
+    if (this != &other)
+    {
+        this->~StaticBatch();
+        new (this) StaticBatch(std::move(other));
+    }
+    return *this;
+}
@@ -1,11 +1,87 @@
 #include "Texture.h"
+#include "DecodeCache.h"
+#include "JobSystem.h"
+#include "GLStateCache.h"
+#include "ResidencyManager.h"
+#include "TextureContainer.h"
+#include <cstring>
 #include <iostream>
+#include <new>
+#include <utility>
 
-Texture::Texture(const char* filepath, unsigned int textureUnit = 0)
-        : ID(0), unit(textureUnit)
+// ---- pixel unpack buffer ring --------------------------------------------
+// one shared ring of GL_PIXEL_UNPACK_BUFFERs for every streamed upload.
+// each upload orphans its buffer (glBufferData with nullptr) before the
+// map, so the memcpy never waits on a transfer that is still in flight,
+// and glTexImage2D then reads out of the PBO via DMA instead of copying
+// synchronously from client memory.
+// (persistent mapping would skip even the map call, but that is GL 4.4
+// and our glad loader only covers 3.3 -> orphaning is the 3.3 way.)
+
+static const int PBO_RING_SIZE = 3;
+static unsigned int pboRing[PBO_RING_SIZE] = {0};
+static size_t pboCapacity[PBO_RING_SIZE] = {0};
+static int pboCursor = 0;
+
+static void uploadThroughPBO(const unsigned char* pixels, size_t bytes,
+                             int width, int height, GLenum format)
+{
+    if (pboRing[0] == 0) {
+        glGenBuffers(PBO_RING_SIZE, pboRing);
+    }
+
+    pboCursor = (pboCursor + 1) % PBO_RING_SIZE;
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pboRing[pboCursor]);
+
+    // (re)allocating = orphaning -> the driver hands us fresh storage
+    // even if the previous contents are still being copied to a texture
+    if (pboCapacity[pboCursor] < bytes) {
+        pboCapacity[pboCursor] = bytes;
+    }
+    glBufferData(GL_PIXEL_UNPACK_BUFFER, pboCapacity[pboCursor], nullptr, GL_STREAM_DRAW);
+
+    void* mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, bytes,
+                                    GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+    if (mapped == nullptr) {
+        // extremely rare, but don't lose the texture over it
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, pixels);
+        glGenerateMipmap(GL_TEXTURE_2D);
+        return;
+    }
+
+    std::memcpy(mapped, pixels, bytes);
+    glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+
+    // with a PBO bound the data argument is an OFFSET, not a client pointer
+    glTexImage2D(GL_TEXTURE_2D, 0, format, width, height, 0, format, GL_UNSIGNED_BYTE, (void*)0);
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+}
+// --------------------------------------------------------------------------
+
+Texture::Texture(const char* filepath, unsigned int textureUnit)
+        : Texture(filepath, textureUnit, false)
+{
+}
+
+// demoted textures keep mips at or below this dimension
+static const int DEMOTED_MAX_DIMENSION = 64;
+
+static bool isContainerPath(const std::string& name)
+{
+    return name.size() > 5 && name.compare(name.size() - 5, 5, ".gltx") == 0;
+}
+
+Texture::Texture(const char* filepath, unsigned int textureUnit, bool streamed)
+        : width(0), height(0), nrChannels(0), ID(0), path(filepath),
+          unit(textureUnit), streaming(streamed)
 {
+    ResidencyManager::shared().add(this);
+
     glGenTextures(1, &ID);
-    glBindTexture(GL_TEXTURE_2D, ID);
+    GLStateCache::shared().bindTexture2D(ID);
 
 
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
@@ -14,17 +90,212 @@ Texture::Texture(const char* filepath, unsigned int textureUnit = 0)
     glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 
     stbi_set_flip_vertically_on_load(true);
-    load_image(filepath);
 
-    std::cout << "loaded texture: " << filepath << std::endl;
+    if (!streaming)
+    {
+        load_image(filepath);
+        gpuBytes = estimateBytes(width, height);
+        ResidencyManager::shared().updateBytes(this, gpuBytes);
+        std::cout << "loaded texture: " << filepath << std::endl;
+        return;
+    }
+
+    // streamed: show a placeholder now, hand the expensive part (disk +
+    // PNG decode) to the shared job pool, upload later in update()
+    createPlaceholder();
+    resident = false;
+    startStreamedDecode();
+}
+
+void Texture::startStreamedDecode() {
+    decode = std::make_shared<DecodeResult>();
+    JobSystem::shared().submit([result = decode, file = path]() {
+        // cache hit = mmap + page-in instead of a PNG inflate
+        result->pixels = cachedDecode(file.c_str(), &result->width, &result->height, &result->nrChannels);
+        result->done = true;
+    });
+}
+
+size_t Texture::estimateBytes(int width, int height) {
+    if (width <= 0 || height <= 0) {
+        return 4; // placeholder
+    }
+    // drivers keep ~4 bytes per texel regardless of source channels;
+    // the mip chain adds another third on top
+    return (size_t)width * height * 4 * 4 / 3;
+}
+
+Texture::DecodeResult::~DecodeResult() {
+    if (pixels != nullptr) {
+        cachedDecodeFree(pixels);
+    }
 }
 
 Texture::~Texture() {
+    ResidencyManager::shared().remove(this);
+    glDeleteTextures(1, &ID);
+    GLStateCache::shared().onTextureDeleted(ID);
+}
+
+Texture::Texture(Texture&& other) noexcept
+    : width(other.width), height(other.height), nrChannels(other.nrChannels),
+      path(std::move(other.path)), ID(other.ID), unit(other.unit),
+      streaming(other.streaming), resident(other.resident),
+      decode(std::move(other.decode)),
+      demoted(other.demoted), gpuBytes(other.gpuBytes)
+{
+    // glDeleteTextures silently ignores id 0, so the source's destructor
+    // becomes a no-op; the residency entry follows the texture
+    ResidencyManager::shared().onMoved(&other, this);
+    other.ID = 0;
+}
+
+Texture& Texture::operator=(Texture&& other) noexcept
+{
+    if (this != &other)
+    {
+        this->~Texture();
+        new (this) Texture(std::move(other));
+    }
+    return *this;
+}
+
+void Texture::createPlaceholder() {
+    // flat grey until the real pixels show up
+    unsigned char grey[3] = {128, 128, 128};
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 1, 1, 0, GL_RGB, GL_UNSIGNED_BYTE, grey);
+}
+
+void Texture::update() {
+    if (resident || !streaming || decode == nullptr || !decode->done) {
+        return;
+    }
+
+    if (decode->pixels == nullptr)
+    {
+        std::cerr << "Failed to load texture: " << path << std::endl;
+        // keep the placeholder, but stop polling
+        decode.reset();
+        resident = true;
+        return;
+    }
+
+    width = decode->width;
+    height = decode->height;
+    nrChannels = decode->nrChannels;
+
+    GLenum format = (nrChannels == 4) ? GL_RGBA : GL_RGB;
+
+    GLStateCache::shared().bindTexture2D(ID);
+    uploadThroughPBO(decode->pixels, (size_t)width * height * nrChannels, width, height, format);
+
+    decode.reset(); // frees the decoded pixels
+    resident = true;
+
+    gpuBytes = estimateBytes(width, height);
+    ResidencyManager::shared().updateBytes(this, gpuBytes);
+
+    std::cout << "streamed texture: " << path << std::endl;
+}
+
+void Texture::demote() {
+    if (demoted || !resident) {
+        return; // never fight an in-flight stream
+    }
+
+    // respecifying level 0 smaller would leave the old mips allocated,
+    // so recreate the texture object outright. the id changes, which is
+    // fine -- everyone re-reads getID() every frame
     glDeleteTextures(1, &ID);
+    GLStateCache::shared().onTextureDeleted(ID);
+    glGenTextures(1, &ID);
+    // the parameter/upload calls below target the ACTIVE unit's binding,
+    // so take the explicit two-step form -- bindTextureUnit may satisfy
+    // the pairing without switching units
+    GLStateCache::shared().activeTexture(unit);
+    GLStateCache::shared().bindTexture2D(ID);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+
+    int tailWidth = 0, tailHeight = 0;
+    if (isContainerPath(path))
+    {
+        // the container has the whole chain baked -> keep just its tail
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        if (uploadTextureContainer(path.c_str(), DEMOTED_MAX_DIMENSION, &tailWidth, &tailHeight))
+        {
+            gpuBytes = estimateBytes(tailWidth, tailHeight);
+        }
+        else
+        {
+            createPlaceholder();
+            gpuBytes = estimateBytes(0, 0);
+        }
+    }
+    else
+    {
+        // no cheap way to get a small mip out of a PNG without decoding
+        // it again -> the tail degenerates to the grey placeholder
+        createPlaceholder();
+        gpuBytes = estimateBytes(0, 0);
+    }
+
+    demoted = true;
+    ResidencyManager::shared().updateBytes(this, gpuBytes);
+}
+
+void Texture::promote() {
+    if (!demoted) {
+        return;
+    }
+    demoted = false;
+
+    // same as demote(): the container upload below issues glTexImage2D
+    // against the active unit, so the unit switch must really happen
+    GLStateCache::shared().activeTexture(unit);
+    GLStateCache::shared().bindTexture2D(ID);
+
+    if (isContainerPath(path))
+    {
+        // no decode involved, just mmap + upload -> do it right here
+        int fullWidth = 0, fullHeight = 0;
+        if (uploadTextureContainer(path.c_str(), 0, &fullWidth, &fullHeight))
+        {
+            width = fullWidth;
+            height = fullHeight;
+            gpuBytes = estimateBytes(width, height);
+            ResidencyManager::shared().updateBytes(this, gpuBytes);
+        }
+        return;
+    }
+
+    // PNG: back through the decode job + PBO ring. the tail keeps
+    // drawing until the full image lands in update()
+    resident = false;
+    streaming = true;
+    startStreamedDecode();
+}
+
+bool Texture::isResident() const {
+    return resident;
 }
 
 void Texture::load_image(const char* filepath) {
-    unsigned char *data = stbi_load(filepath, &width, &height, &nrChannels, 0);
+    // baked .gltx containers skip stbi and glGenerateMipmap entirely --
+    // every mip level is uploaded as-is out of the memory-mapped file
+    if (isContainerPath(filepath))
+    {
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+        if (!uploadTextureContainer(filepath, 0, &width, &height))
+        {
+            std::cerr << "Failed to load texture container: " << filepath << std::endl;
+        }
+        return;
+    }
+
+    unsigned char *data = cachedDecode(filepath, &width, &height, &nrChannels);
 
     if (data == nullptr)
     {
@@ -36,14 +307,16 @@ void Texture::load_image(const char* filepath) {
         glGenerateMipmap(GL_TEXTURE_2D);
     }
 
-    stbi_image_free(data);   
+    cachedDecodeFree(data);
 }
 
 void Texture::bind() const {
-    glActiveTexture(GL_TEXTURE0 + unit);
-    glBindTexture(GL_TEXTURE_2D, ID);
+    // stamp the LRU clock (and kick off a promotion if we were demoted)
+    ResidencyManager::shared().touch(this);
+
+    GLStateCache::shared().bindTextureUnit(unit, ID);
 }
 
 void Texture::unbind() const {
-    glBindTexture(GL_TEXTURE_2D, 0);
-}
\ No newline at end of file
+    GLStateCache::shared().bindTexture2D(0);
+}
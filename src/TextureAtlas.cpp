@@ -0,0 +1,118 @@
+#include "TextureAtlas.h"
+#include "GLStateCache.h"
+#include <iostream>
+
+// one transparent pixel of spacing so GL_LINEAR filtering never bleeds
+// a neighbour image into a sprite's edge
+static const int PADDING = 1;
+
+TextureAtlas::TextureAtlas(int width, int height, unsigned int textureUnit)
+        : width(width), height(height), ID(0), unit(textureUnit)
+{
+    pixels.resize((size_t)width * height * 4, 0);
+
+    glGenTextures(1, &ID);
+    GLStateCache::shared().bindTexture2D(ID);
+
+    // clamp, not repeat -> a sprite's uv rect must never wrap around into
+    // somebody else's pixels
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+}
+
+TextureAtlas::~TextureAtlas() {
+    glDeleteTextures(1, &ID);
+    GLStateCache::shared().onTextureDeleted(ID);
+}
+
+AtlasRegion TextureAtlas::addImage(const char* filepath) {
+    AtlasRegion region;
+
+    stbi_set_flip_vertically_on_load(true);
+
+    int imageWidth = 0, imageHeight = 0, nrChannels = 0;
+    unsigned char* data = stbi_load(filepath, &imageWidth, &imageHeight, &nrChannels, 4);
+    if (data == nullptr)
+    {
+        std::cerr << "Failed to load atlas image: " << filepath << std::endl;
+        return region;
+    }
+
+    // shelf packing: try the current shelf, else open a new one below
+    if (shelfX + imageWidth + PADDING > width)
+    {
+        shelfX = 0;
+        shelfY += shelfHeight + PADDING;
+        shelfHeight = 0;
+    }
+
+    if (imageWidth + PADDING > width || shelfY + imageHeight + PADDING > height)
+    {
+        std::cerr << "ERROR::ATLAS::FULL: no room for " << filepath
+                  << " (" << imageWidth << "x" << imageHeight << ")" << std::endl;
+        stbi_image_free(data);
+        return region;
+    }
+
+    // blit the decoded RGBA rows into the atlas sheet
+    for (int row = 0; row < imageHeight; row++)
+    {
+        unsigned char* dst = pixels.data() + (((size_t)(shelfY + row) * width) + shelfX) * 4;
+        const unsigned char* src = data + (size_t)row * imageWidth * 4;
+        std::copy(src, src + (size_t)imageWidth * 4, dst);
+    }
+
+    region.u0 = (float)shelfX / width;
+    region.v0 = (float)shelfY / height;
+    region.u1 = (float)(shelfX + imageWidth) / width;
+    region.v1 = (float)(shelfY + imageHeight) / height;
+    region.valid = true;
+
+    shelfX += imageWidth + PADDING;
+    if (imageHeight > shelfHeight)
+    {
+        shelfHeight = imageHeight;
+    }
+
+    stbi_image_free(data);
+    dirty = true;
+
+    std::cout << "packed atlas image: " << filepath << std::endl;
+    return region;
+}
+
+void TextureAtlas::build() {
+    if (!dirty)
+    {
+        return;
+    }
+
+    GLStateCache::shared().bindTexture2D(ID);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+    glGenerateMipmap(GL_TEXTURE_2D);
+
+    dirty = false;
+}
+
+void TextureAtlas::bind() const {
+    GLStateCache::shared().bindTextureUnit(unit, ID);
+}
+
+void TextureAtlas::unbind() const {
+    GLStateCache::shared().bindTexture2D(0);
+}
+
+void TextureAtlas::remapUV(const AtlasRegion &region, float &u, float &v) {
+    u = region.u0 + u * (region.u1 - region.u0);
+    v = region.v0 + v * (region.v1 - region.v0);
+}
+
+void TextureAtlas::remapUVs(std::vector<float> &vertices, const AtlasRegion &region) {
+    // standard layout: 8 floats per vertex, uv lives at offset 6
+    for (size_t i = 6; i + 1 < vertices.size(); i += 8)
+    {
+        remapUV(region, vertices[i], vertices[i + 1]);
+    }
+}
@@ -0,0 +1,317 @@
+#include "TextureContainer.h"
+
+#include <stb_image/stb_image.h>
+
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// core glad 3.3 does not carry the s3tc extension enum
+#ifndef GL_COMPRESSED_RGB_S3TC_DXT1_EXT
+#define GL_COMPRESSED_RGB_S3TC_DXT1_EXT 0x83F0
+#endif
+
+static const char GLTX_MAGIC[4] = {'G', 'L', 'T', 'X'};
+static const unsigned int GLTX_VERSION = 1;
+
+// ---- bake helpers --------------------------------------------------------
+
+// halve an RGBA8 image with a 2x2 box filter (the usual mip chain step)
+static std::vector<unsigned char> downsample(const std::vector<unsigned char>& src,
+                                             int width, int height, int& outWidth, int& outHeight)
+{
+    outWidth = (width > 1) ? width / 2 : 1;
+    outHeight = (height > 1) ? height / 2 : 1;
+
+    std::vector<unsigned char> dst((size_t)outWidth * outHeight * 4);
+    for (int y = 0; y < outHeight; y++)
+    {
+        for (int x = 0; x < outWidth; x++)
+        {
+            int srcX = x * 2, srcY = y * 2;
+            int srcX1 = (srcX + 1 < width) ? srcX + 1 : srcX;
+            int srcY1 = (srcY + 1 < height) ? srcY + 1 : srcY;
+
+            for (int channel = 0; channel < 4; channel++)
+            {
+                int sum = src[((size_t)srcY * width + srcX) * 4 + channel]
+                        + src[((size_t)srcY * width + srcX1) * 4 + channel]
+                        + src[((size_t)srcY1 * width + srcX) * 4 + channel]
+                        + src[((size_t)srcY1 * width + srcX1) * 4 + channel];
+                dst[((size_t)y * outWidth + x) * 4 + channel] = (unsigned char)(sum / 4);
+            }
+        }
+    }
+    return dst;
+}
+
+static unsigned short toRGB565(const unsigned char* rgba)
+{
+    return (unsigned short)(((rgba[0] >> 3) << 11) | ((rgba[1] >> 2) << 5) | (rgba[2] >> 3));
+}
+
+// quick BC1 encoder: endpoints are the brightest and darkest texel of the
+// block, every texel picks the nearest of the 4 palette colors. not
+// libsquish quality, but bake-time cheap and fine for our asset set
+static void encodeBlockBC1(const unsigned char block[16][4], unsigned char out[8])
+{
+    int minLuma = 255 * 3 + 1, maxLuma = -1;
+    int minIndex = 0, maxIndex = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        int luma = block[i][0] + block[i][1] + block[i][2];
+        if (luma < minLuma) { minLuma = luma; minIndex = i; }
+        if (luma > maxLuma) { maxLuma = luma; maxIndex = i; }
+    }
+
+    unsigned short c0 = toRGB565(block[maxIndex]);
+    unsigned short c1 = toRGB565(block[minIndex]);
+
+    // c0 > c1 selects the opaque 4-color mode
+    if (c0 < c1)
+    {
+        std::swap(c0, c1);
+        std::swap(minIndex, maxIndex);
+    }
+
+    // reconstruct the 4 palette entries the decoder will see
+    unsigned char palette[4][3];
+    for (int channel = 0; channel < 3; channel++)
+    {
+        palette[0][channel] = block[maxIndex][channel];
+        palette[1][channel] = block[minIndex][channel];
+        palette[2][channel] = (unsigned char)((2 * palette[0][channel] + palette[1][channel]) / 3);
+        palette[3][channel] = (unsigned char)((palette[0][channel] + 2 * palette[1][channel]) / 3);
+    }
+
+    unsigned int indices = 0;
+    for (int i = 0; i < 16; i++)
+    {
+        int best = 0, bestDistance = 1 << 30;
+        for (int entry = 0; entry < 4; entry++)
+        {
+            int dr = block[i][0] - palette[entry][0];
+            int dg = block[i][1] - palette[entry][1];
+            int db = block[i][2] - palette[entry][2];
+            int distance = dr * dr + dg * dg + db * db;
+            if (distance < bestDistance)
+            {
+                bestDistance = distance;
+                best = entry;
+            }
+        }
+        indices |= (unsigned int)best << (i * 2);
+    }
+
+    std::memcpy(out + 0, &c0, 2);
+    std::memcpy(out + 2, &c1, 2);
+    std::memcpy(out + 4, &indices, 4);
+}
+
+static std::vector<unsigned char> encodeBC1(const std::vector<unsigned char>& rgba, int width, int height)
+{
+    int blocksX = (width + 3) / 4;
+    int blocksY = (height + 3) / 4;
+
+    std::vector<unsigned char> out((size_t)blocksX * blocksY * 8);
+    for (int by = 0; by < blocksY; by++)
+    {
+        for (int bx = 0; bx < blocksX; bx++)
+        {
+            // gather the 4x4 block, clamping at the image edge
+            unsigned char block[16][4];
+            for (int i = 0; i < 16; i++)
+            {
+                int x = bx * 4 + (i % 4);
+                int y = by * 4 + (i / 4);
+                if (x >= width) x = width - 1;
+                if (y >= height) y = height - 1;
+                std::memcpy(block[i], &rgba[((size_t)y * width + x) * 4], 4);
+            }
+            encodeBlockBC1(block, &out[((size_t)by * blocksX + bx) * 8]);
+        }
+    }
+    return out;
+}
+
+// ---- bake ----------------------------------------------------------------
+
+bool bakeTextureContainer(const char* imagePath, const char* outPath, bool blockCompress)
+{
+    stbi_set_flip_vertically_on_load(true);
+
+    int width = 0, height = 0, nrChannels = 0;
+    unsigned char* data = stbi_load(imagePath, &width, &height, &nrChannels, 4);
+    if (data == nullptr)
+    {
+        std::cerr << "Failed to load image for baking: " << imagePath << std::endl;
+        return false;
+    }
+
+    std::ofstream file(outPath, std::ios::binary | std::ios::trunc);
+    if (!file.is_open())
+    {
+        std::cerr << "ERROR::GLTX::NOT_WRITABLE: " << outPath << std::endl;
+        stbi_image_free(data);
+        return false;
+    }
+
+    // count mips down to 1x1
+    unsigned int mipLevels = 1;
+    for (int size = (width > height ? width : height); size > 1; size /= 2)
+    {
+        mipLevels++;
+    }
+
+    unsigned int format = blockCompress ? GLTX_BC1 : GLTX_RGBA8;
+    file.write(GLTX_MAGIC, 4);
+    file.write(reinterpret_cast<const char*>(&GLTX_VERSION), 4);
+    file.write(reinterpret_cast<const char*>(&width), 4);
+    file.write(reinterpret_cast<const char*>(&height), 4);
+    file.write(reinterpret_cast<const char*>(&mipLevels), 4);
+    file.write(reinterpret_cast<const char*>(&format), 4);
+
+    std::vector<unsigned char> level(data, data + (size_t)width * height * 4);
+    stbi_image_free(data);
+
+    int levelWidth = width, levelHeight = height;
+    for (unsigned int mip = 0; mip < mipLevels; mip++)
+    {
+        std::vector<unsigned char> payload =
+            blockCompress ? encodeBC1(level, levelWidth, levelHeight) : level;
+
+        unsigned int byteSize = (unsigned int)payload.size();
+        file.write(reinterpret_cast<const char*>(&byteSize), 4);
+        file.write(reinterpret_cast<const char*>(payload.data()), byteSize);
+
+        if (mip + 1 < mipLevels)
+        {
+            int nextWidth, nextHeight;
+            level = downsample(level, levelWidth, levelHeight, nextWidth, nextHeight);
+            levelWidth = nextWidth;
+            levelHeight = nextHeight;
+        }
+    }
+
+    std::cout << "baked texture container: " << outPath
+              << " (" << mipLevels << " mips, " << (blockCompress ? "BC1" : "RGBA8") << ")" << std::endl;
+    return true;
+}
+
+// ---- runtime load --------------------------------------------------------
+
+bool uploadTextureContainer(const char* path, int maxDimension,
+                            int* outWidth, int* outHeight)
+{
+    int fd = open(path, O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    struct stat fileInfo;
+    if (fstat(fd, &fileInfo) != 0 || fileInfo.st_size < 24)
+    {
+        close(fd);
+        return false;
+    }
+
+    // map the whole file; the upload reads each level in place, so the
+    // only copies are the driver's own
+    const unsigned char* base = (const unsigned char*)mmap(nullptr, fileInfo.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (base == MAP_FAILED)
+    {
+        return false;
+    }
+
+    const unsigned char* cursor = base;
+    const unsigned char* end = base + fileInfo.st_size;
+
+    unsigned int version, format, mipLevels;
+    int width, height;
+    bool ok = std::memcmp(cursor, GLTX_MAGIC, 4) == 0;
+    cursor += 4;
+    std::memcpy(&version, cursor, 4); cursor += 4;
+    std::memcpy(&width, cursor, 4); cursor += 4;
+    std::memcpy(&height, cursor, 4); cursor += 4;
+    std::memcpy(&mipLevels, cursor, 4); cursor += 4;
+    std::memcpy(&format, cursor, 4); cursor += 4;
+
+    ok = ok && version == GLTX_VERSION && (format == GLTX_RGBA8 || format == GLTX_BC1);
+
+    // residency demotion: skip the big mips entirely, the tail of the
+    // chain shifts up to become levels 0..n
+    unsigned int skip = 0;
+    if (ok && maxDimension > 0)
+    {
+        int skipWidth = width, skipHeight = height;
+        while (skip + 1 < mipLevels && (skipWidth > maxDimension || skipHeight > maxDimension))
+        {
+            skipWidth = (skipWidth > 1) ? skipWidth / 2 : 1;
+            skipHeight = (skipHeight > 1) ? skipHeight / 2 : 1;
+            skip++;
+        }
+    }
+
+    int levelWidth = width, levelHeight = height;
+    for (unsigned int mip = 0; ok && mip < mipLevels; mip++)
+    {
+        if (cursor + 4 > end)
+        {
+            ok = false;
+            break;
+        }
+
+        unsigned int byteSize;
+        std::memcpy(&byteSize, cursor, 4); cursor += 4;
+        if (cursor + byteSize > end)
+        {
+            ok = false;
+            break;
+        }
+
+        if (mip >= skip)
+        {
+            if (mip == skip)
+            {
+                if (outWidth != nullptr) *outWidth = levelWidth;
+                if (outHeight != nullptr) *outHeight = levelHeight;
+            }
+
+            if (format == GLTX_BC1)
+            {
+                glCompressedTexImage2D(GL_TEXTURE_2D, mip - skip, GL_COMPRESSED_RGB_S3TC_DXT1_EXT,
+                                       levelWidth, levelHeight, 0, byteSize, cursor);
+            }
+            else
+            {
+                glTexImage2D(GL_TEXTURE_2D, mip - skip, GL_RGBA, levelWidth, levelHeight, 0,
+                             GL_RGBA, GL_UNSIGNED_BYTE, cursor);
+            }
+        }
+        cursor += byteSize;
+
+        levelWidth = (levelWidth > 1) ? levelWidth / 2 : 1;
+        levelHeight = (levelHeight > 1) ? levelHeight / 2 : 1;
+    }
+
+    if (ok)
+    {
+        // the chain is complete -> no glGenerateMipmap, just tell GL so
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAX_LEVEL, mipLevels - 1 - skip);
+    }
+    else
+    {
+        std::cerr << "ERROR::GLTX::MALFORMED: " << path << std::endl;
+    }
+
+    munmap((void*)base, fileInfo.st_size);
+    return ok;
+}
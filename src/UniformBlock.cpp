@@ -0,0 +1,34 @@
+#include <UniformBlock.h>
+
+#include <iostream>
+
+UniformBlock::UniformBlock(const std::string &name, unsigned int bindingPoint, size_t byteSize)
+    : name(name), bindingPoint(bindingPoint), UBO(0), byteSize(byteSize)
+{
+    glGenBuffers(1, &UBO);
+    glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    glBufferData(GL_UNIFORM_BUFFER, byteSize, nullptr, GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+    // park the whole buffer on its binding point once; shaders attach to
+    // the point, so this never has to be rebound per frame
+    glBindBufferBase(GL_UNIFORM_BUFFER, bindingPoint, UBO);
+}
+
+UniformBlock::~UniformBlock()
+{
+    glDeleteBuffers(1, &UBO);
+}
+
+void UniformBlock::upload(const void* data, size_t bytes, size_t offset)
+{
+    if (offset + bytes > byteSize)
+    {
+        std::cerr << "ERROR::UNIFORMBLOCK::UPLOAD_OUT_OF_RANGE: " << name << std::endl;
+        return;
+    }
+
+    glBindBuffer(GL_UNIFORM_BUFFER, UBO);
+    glBufferSubData(GL_UNIFORM_BUFFER, offset, bytes, data);
+    glBindBuffer(GL_UNIFORM_BUFFER, 0);
+}
@@ -1,8 +1,15 @@
 #include <Window.h>
 
+#include <cstring>
 
-Window::Window(int width, int height, const char* title) 
-    : width(width), height(height), title(title)
+
+Window::Window(int width, int height, const char* title)
+    : Window(width, height, title, false)
+{
+}
+
+Window::Window(int width, int height, const char* title, bool headless)
+    : width(width), height(height), title(title), headless(headless)
 {
     if (!glfwInit())
     {
@@ -13,8 +20,14 @@ Window::Window(int width, int height, const char* title)
     glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 3);
     glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
 
+    if (headless)
+    {
+        // hidden window: we only want the GL context, nobody will see it
+        glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    }
+
     window = glfwCreateWindow(width, height, title, nullptr, nullptr);
-    
+
     if (window == nullptr)
     {
         glfwTerminate();
@@ -30,6 +43,84 @@ Window::Window(int width, int height, const char* title)
 
     glViewport(0, 0, width, height);
     glfwSetFramebufferSizeCallback(window, framebuffer_size_callback);
+
+    if (headless)
+    {
+        // frames go into our own FBO and are never tied to the monitor
+        glfwSwapInterval(0);
+        createOffscreenTarget();
+    }
+}
+
+void Window::createOffscreenTarget()
+{
+    glGenFramebuffers(1, &FBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, FBO);
+
+    glGenRenderbuffers(1, &colorRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, colorRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, colorRBO);
+
+    glGenRenderbuffers(1, &depthRBO);
+    glBindRenderbuffer(GL_RENDERBUFFER, depthRBO);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, depthRBO);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE)
+    {
+        throw std::runtime_error("Failed to create offscreen framebuffer");
+    }
+
+    // everything after this renders offscreen
+    glViewport(0, 0, width, height);
+
+    // double buffered readback PBOs, sized for RGBA8 frames
+    glGenBuffers(2, readPBO);
+    for (int i = 0; i < 2; i++)
+    {
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readPBO[i]);
+        glBufferData(GL_PIXEL_PACK_BUFFER, (size_t)width * height * 4, nullptr, GL_STREAM_READ);
+    }
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+}
+
+bool Window::renderFrameTo(unsigned char* pixels)
+{
+    if (!headless)
+    {
+        std::cerr << "renderFrameTo() only works on headless windows" << std::endl;
+        return false;
+    }
+
+    // kick off the readback of the frame just rendered into one PBO;
+    // glReadPixels into a PBO returns immediately
+    glBindFramebuffer(GL_READ_FRAMEBUFFER, FBO);
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, readPBO[readIndex]);
+    glReadPixels(0, 0, width, height, GL_RGBA, GL_UNSIGNED_BYTE, 0);
+
+    bool gotFrame = false;
+    int previous = 1 - readIndex;
+
+    if (readPrimed)
+    {
+        // the OTHER PBO holds last frame's pixels, finished by now ->
+        // mapping it is cheap instead of a pipeline stall
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readPBO[previous]);
+        void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, (size_t)width * height * 4, GL_MAP_READ_BIT);
+        if (mapped != nullptr)
+        {
+            std::memcpy(pixels, mapped, (size_t)width * height * 4);
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+            gotFrame = true;
+        }
+    }
+
+    glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+
+    readIndex = previous;
+    readPrimed = true;
+    return gotFrame;
 }
 
 
@@ -38,8 +129,23 @@ bool Window::windowShouldClose()
     return glfwWindowShouldClose(window);
 }
 
+void Window::setSwapInterval(int interval)
+{
+    if (headless)
+    {
+        return; // offscreen frames never meet the monitor anyway
+    }
+    glfwSwapInterval(interval);
+}
+
 void Window::swapBuffers()
 {
+    if (headless)
+    {
+        // nothing to present -- just push the commands along
+        glFlush();
+        return;
+    }
     glfwSwapBuffers(window);
 }
 
@@ -66,6 +172,14 @@ void Window::processInput()
 // Destructor
 Window::~Window()
 {
+    if (headless)
+    {
+        glDeleteBuffers(2, readPBO);
+        glDeleteRenderbuffers(1, &colorRBO);
+        glDeleteRenderbuffers(1, &depthRBO);
+        glDeleteFramebuffers(1, &FBO);
+    }
+
     glfwDestroyWindow(window);
     glfwTerminate();
 }
\ No newline at end of file
@@ -0,0 +1,308 @@
+#include <glad/glad.h>
+#include <GLFW/glfw3.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <string>
+#include <vector>
+
+#include <glm/glm.hpp>
+#include <glm/gtc/matrix_transform.hpp>
+
+#include "Window.h"
+#include "Shader.h"
+#include "Utils.h"
+#include "Mesh.h"
+#include "Texture.h"
+#include "FrameArena.h"
+#include "GLStateCache.h"
+#include "Renderer.h"
+#include "Profiler.h"
+#include "ResourcePool.h"
+#include "UniformBlock.h"
+
+// benchmark harness: renders parameterized stress scenes (N meshes x
+// M textures x K shaders, up to 100k draws per frame) headless for a
+// fixed frame count and prints the timings as JSON, so runs can be
+// compared per commit and across driver updates:
+//
+//     ./bench --draws 10000 --meshes 256 --textures 16 --shaders 8 \
+//             --frames 240 --out bench.json
+//
+// every draw cycles through the mesh/texture/shader pools, so the
+// renderer's sort-and-batch path sees realistic state-change pressure
+// instead of one repeated draw.
+
+struct BenchConfig {
+    int meshes = 64;
+    int textures = 8;   // rounded up to even (they bind in unit 0/1 pairs)
+    int shaders = 4;
+    int draws = 4096;   // submissions per frame
+    int frames = 240;   // measured frames
+    int warmup = 32;    // frames before measurement starts
+    int width = 1280;
+    int height = 720;
+    std::string out;    // empty -> stdout
+};
+
+// same std140 block main.cpp uploads; see FrameData in vertthing.vert
+struct FrameData {
+    glm::mat4 view;
+    glm::mat4 projection;
+    float time;
+    float pad[3];
+};
+
+static BenchConfig parseArgs(int argc, char** argv)
+{
+    BenchConfig config;
+    for (int i = 1; i + 1 < argc; i += 2)
+    {
+        std::string flag = argv[i];
+        const char* value = argv[i + 1];
+
+        if (flag == "--meshes")        config.meshes = std::atoi(value);
+        else if (flag == "--textures") config.textures = std::atoi(value);
+        else if (flag == "--shaders")  config.shaders = std::atoi(value);
+        else if (flag == "--draws")    config.draws = std::atoi(value);
+        else if (flag == "--frames")   config.frames = std::atoi(value);
+        else if (flag == "--warmup")   config.warmup = std::atoi(value);
+        else if (flag == "--width")    config.width = std::atoi(value);
+        else if (flag == "--height")   config.height = std::atoi(value);
+        else if (flag == "--out")      config.out = value;
+        else
+        {
+            std::fprintf(stderr, "unknown flag: %s\n", flag.c_str());
+            std::exit(1);
+        }
+    }
+
+    config.meshes = std::max(config.meshes, 1);
+    config.textures = std::max(config.textures + (config.textures % 2), 2);
+    config.shaders = std::max(config.shaders, 1);
+    config.draws = std::max(config.draws, 1);
+    config.frames = std::max(config.frames, 1);
+    config.warmup = std::max(config.warmup, 0);
+    return config;
+}
+
+static float percentile(std::vector<float> samples, float fraction)
+{
+    if (samples.empty())
+    {
+        return 0.0f;
+    }
+    std::sort(samples.begin(), samples.end());
+    size_t index = (size_t)(fraction * (samples.size() - 1));
+    return samples[index];
+}
+
+static float average(const std::vector<float>& samples)
+{
+    if (samples.empty())
+    {
+        return 0.0f;
+    }
+    float sum = 0.0f;
+    for (float sample : samples)
+    {
+        sum += sample;
+    }
+    return sum / samples.size();
+}
+
+static void writeStats(std::FILE* file, const char* name, const std::vector<float>& samples)
+{
+    std::fprintf(file,
+                 "  \"%s\": {\"avg\": %.4f, \"p50\": %.4f, \"p95\": %.4f, \"p99\": %.4f}",
+                 name, average(samples), percentile(samples, 0.50f),
+                 percentile(samples, 0.95f), percentile(samples, 0.99f));
+}
+
+int main(int argc, char** argv)
+{
+    BenchConfig config = parseArgs(argc, argv);
+
+    // hidden window + offscreen target: no vsync, no monitor involved
+    Window window(config.width, config.height, "bench", true);
+
+    // the hexagon the demo draws, reused as the stress primitive
+    std::vector<float> vertices = {
+        0.0f, 0.0f, 0.0f, 1.0f, 1.0f, 1.0f, 0.5f, 0.5f,
+        0.0f, 0.5f, 0.0f, 1.0f, 0.0f, 0.0f, 0.5f, 1.0f,
+        0.43f, 0.25f, 0.0f, 0.0f, 1.0f, 0.0f, 0.93f, 0.75f,
+        0.43f, -0.25f, 0.0f, 0.0f, 0.0f, 1.0f, 0.93f, 0.25f,
+        0.0f, -0.5f, 0.0f, 1.0f, 1.0f, 0.0f, 0.5f, 0.0f,
+        -0.43f, -0.25f, 0.0f, 0.0f, 1.0f, 1.0f, 0.07f, 0.25f,
+        -0.43f, 0.25f, 0.0f, 1.0f, 0.0f, 1.0f, 0.07f, 0.75f,
+    };
+    std::vector<unsigned int> indices = {0, 1, 2, 3, 4, 5, 6, 1};
+
+    // N distinct meshes (distinct VAOs/VBOs) so VAO switching is real.
+    // everything lives in generation-checked pools: contiguous storage,
+    // handles instead of heap pointers
+    ResourcePool<Mesh> meshPool;
+    std::vector<ResourcePool<Mesh>::Handle> meshes;
+    for (int i = 0; i < config.meshes; i++)
+    {
+        meshes.push_back(meshPool.add(Mesh(vertices, indices, GL_TRIANGLE_FAN)));
+    }
+
+    // K programs compiled from the same source still have distinct ids,
+    // which is exactly what a glUseProgram switch costs
+    std::string vertPath = getExecutableDir() + "/vs/vertthing.vert";
+    std::string fragPath = getExecutableDir() + "/fs/fragthing.frag";
+    ResourcePool<Shader> shaderPool;
+    std::vector<ResourcePool<Shader>::Handle> shaders;
+    for (int i = 0; i < config.shaders; i++)
+    {
+        shaders.push_back(shaderPool.add(Shader(vertPath.c_str(), fragPath.c_str())));
+
+        Shader* shader = shaderPool.get(shaders.back());
+        shader->bindUniformBlock("FrameData", 0);
+        shader->initialize();
+        shader->setInt("myTexture1", 0);
+        shader->setInt("myTexture2", 1);
+    }
+
+    // M textures in unit 0/1 pairs, alternating between the two shipped
+    // images; each Texture is its own GL object, so binds are real too
+    std::string imagePaths[2] = {
+        getExecutableDir() + "/images/stoneimage.png",
+        getExecutableDir() + "/images/smileyface.png",
+    };
+    ResourcePool<Texture> texturePool;
+    std::vector<ResourcePool<Texture>::Handle> textures;
+    for (int i = 0; i < config.textures; i++)
+    {
+        textures.push_back(texturePool.add(Texture(imagePaths[(i / 2) % 2].c_str(), i % 2)));
+    }
+
+    UniformBlock frameDataBlock("FrameData", 0, sizeof(FrameData));
+
+    Renderer renderer;
+    renderer.setFrustum(glm::mat4(1.0f));
+
+    // thousands of draws per frame is exactly what the parallel recorder
+    // is for: workers cull/sort shards, the context thread just replays
+    renderer.setParallelRecordingEnabled(true);
+
+    Profiler profiler;
+
+    // fixed seed -> every run draws the identical scene
+    std::mt19937 rng(12345);
+    std::uniform_real_distribution<float> position(-0.95f, 0.95f);
+    std::vector<glm::mat4> transforms;
+    transforms.reserve(config.draws);
+    for (int i = 0; i < config.draws; i++)
+    {
+        glm::mat4 transform = glm::translate(glm::mat4(1.0f),
+                                             glm::vec3(position(rng), position(rng), 0.0f));
+        transforms.push_back(glm::scale(transform, glm::vec3(0.05f)));
+    }
+
+    // keep at most two frames in flight (same fence idiom the dynamic
+    // mesh uses), otherwise CPU timings measure only command recording
+    // while the GPU backlog grows without bound
+    const int MAX_FRAMES_IN_FLIGHT = 2;
+    GLsync frameFence[MAX_FRAMES_IN_FLIGHT] = {nullptr, nullptr};
+    int fenceIndex = 0;
+
+    std::vector<float> cpuMs, gpuMs, drawCallCounts;
+    cpuMs.reserve(config.frames);
+    gpuMs.reserve(config.frames);
+    drawCallCounts.reserve(config.frames);
+
+    int totalFrames = config.warmup + config.frames;
+    for (int frame = 0; frame < totalFrames; frame++)
+    {
+        profiler.beginFrame();
+
+        GLStateCache::shared().clearColor(0.0f, 0.0f, 0.0f, 1.0f);
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        FrameData frameData = {};
+        frameData.view = glm::mat4(1.0f);
+        frameData.projection = glm::mat4(1.0f);
+        frameData.time = (float)glfwGetTime();
+        frameDataBlock.upload(&frameData, sizeof(frameData));
+
+        for (int draw = 0; draw < config.draws; draw++)
+        {
+            renderer.submit(*meshPool.get(meshes[draw % config.meshes]),
+                            *shaderPool.get(shaders[draw % config.shaders]),
+                            {texturePool.get(textures[(2 * draw) % config.textures]),
+                             texturePool.get(textures[(2 * draw + 1) % config.textures])},
+                            transforms[draw]);
+        }
+
+        profiler.beginGpu("flush");
+        renderer.flush();
+        profiler.endGpu();
+
+        window.swapBuffers();
+        window.pollEvents();
+
+        if (frameFence[fenceIndex] != nullptr)
+        {
+            glClientWaitSync(frameFence[fenceIndex], GL_SYNC_FLUSH_COMMANDS_BIT, GL_TIMEOUT_IGNORED);
+            glDeleteSync(frameFence[fenceIndex]);
+        }
+        frameFence[fenceIndex] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+        fenceIndex = (fenceIndex + 1) % MAX_FRAMES_IN_FLIGHT;
+
+        profiler.endFrame();
+        FrameArena::threadLocal().reset();
+
+        if (frame >= config.warmup)
+        {
+            cpuMs.push_back(profiler.lastMs("frame"));
+            gpuMs.push_back(profiler.lastMs("flush (gpu)"));
+            drawCallCounts.push_back((float)renderer.getLastDrawCallCount());
+        }
+    }
+
+    for (int i = 0; i < MAX_FRAMES_IN_FLIGHT; i++)
+    {
+        if (frameFence[i] != nullptr)
+        {
+            glDeleteSync(frameFence[i]);
+        }
+    }
+
+    std::FILE* file = stdout;
+    if (!config.out.empty())
+    {
+        file = std::fopen(config.out.c_str(), "w");
+        if (file == nullptr)
+        {
+            std::fprintf(stderr, "failed to open %s\n", config.out.c_str());
+            return 1;
+        }
+    }
+
+    std::fprintf(file, "{\n");
+    std::fprintf(file,
+                 "  \"config\": {\"meshes\": %d, \"textures\": %d, \"shaders\": %d, "
+                 "\"draws\": %d, \"frames\": %d, \"warmup\": %d, "
+                 "\"width\": %d, \"height\": %d},\n",
+                 config.meshes, config.textures, config.shaders, config.draws,
+                 config.frames, config.warmup, config.width, config.height);
+    std::fprintf(file, "  \"renderer\": \"%s\",\n", (const char*)glGetString(GL_RENDERER));
+    std::fprintf(file, "  \"gl_version\": \"%s\",\n", (const char*)glGetString(GL_VERSION));
+    writeStats(file, "cpu_ms", cpuMs);
+    std::fprintf(file, ",\n");
+    writeStats(file, "gpu_ms", gpuMs);
+    std::fprintf(file, ",\n");
+    std::fprintf(file, "  \"draw_calls_per_frame\": %.1f\n", average(drawCallCounts));
+    std::fprintf(file, "}\n");
+
+    if (file != stdout)
+    {
+        std::fclose(file);
+    }
+    return 0;
+}
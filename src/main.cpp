@@ -2,6 +2,7 @@
 #include <GLFW/glfw3.h>
 #include <stb_image/stb_image.h>
 
+#include <cstdio>
 #include <string>
 #include <vector>
 #include <iostream>
@@ -15,6 +16,28 @@
 #include "Utils.h"
 #include "Mesh.h"
 #include "Texture.h"
+#include "Renderer.h"
+#include "Profiler.h"
+#include "Scene.h"
+#include "UniformBlock.h"
+#include "DebugText.h"
+#include "StaticBatch.h"
+#include "FixedTimestep.h"
+#include "FrameArena.h"
+#include "ResidencyManager.h"
+#include "GLStateCache.h"
+#include "RenderGraph.h"
+
+#include <cmath>
+
+// CPU mirror of the FrameData block in vertthing.vert (std140 layout:
+// two mat4s then a float padded out to 16 bytes)
+struct FrameData {
+    glm::mat4 view;
+    glm::mat4 projection;
+    float time;
+    float pad[3];
+};
 
 // float vertices[] = {
 //     // positions            // colors
@@ -45,75 +68,209 @@ int main()
         -0.43f, 0.25f, 0.0f, 1.0f, 0.0f, 1.0f, 0.07f, 0.75f,  // 6: Top-left (magenta)
     };
 
-    std::vector<unsigned int> indices = {
-        // Triangles to form the hexagon
-        // 0, 1, 2, // Center, Top, Top-right
-        // 0, 2, 3, // Center, Top-right, Bottom-right
-        // 0, 3, 4, // Center, Bottom-right, Bottom
-        // 0, 4, 5, // Center, Bottom, Bottom-left
-        // 0, 5, 6, // Center, Bottom-left, Top-left
-        // 0, 6, 1, // Center, Top-left, Top
-
-        0, 1, 2, 3, 4, 5, 6, 1 // Center, Top, Top-right, Bottom-right, Bottom, Bottom-left, Top-left, Top
-    };
-
     // ---------- Window Initialization ----------
     Window window(800, 600, "Hexagon with Texture");
     
     // ---------- Shader Initialization ----------
     Shader shaderprog((getExecutableDir() + "/vs/vertthing.vert").c_str(), (getExecutableDir() + "/fs/fragthing.frag").c_str());
 
-    // vertex array object (VAO) AND vertex buffer object (VBO)
-    Mesh hexagonMesh(vertices, indices);
+    // shared per-frame globals: one UBO upload per frame, every shader
+    // that declares FrameData reads the same buffer
+    UniformBlock frameDataBlock("FrameData", 0, sizeof(FrameData));
+    shaderprog.bindUniformBlock("FrameData", 0);
+
+    // hexagon as a plain triangle list (the old fan, fanned out: the LOD
+    // simplifier and the static batch both want triangles)
+    std::vector<unsigned int> triangleIndices = {
+        0, 1, 2, 0, 2, 3, 0, 3, 4, 0, 4, 5, 0, 5, 6, 0, 6, 1,
+    };
+
+    // vertex array object (VAO) AND vertex buffer object (VBO). built
+    // with a 3-level LOD chain -- at 7 vertices the simplifier stops
+    // after level 0, but a real asset dropped in here gets distance-based
+    // detail for free
+    Mesh hexagonMesh(vertices, triangleIndices, 3, GL_TRIANGLES);
+
+    // static backdrop: a ring of small hexagons merged into one shared
+    // VBO/EBO and drawn with a single (multi-draw indirect) call, their
+    // transforms baked into the vertices at build time
+    StaticBatch staticBatch;
+    for (int i = 0; i < 8; i++)
+    {
+        float angle = glm::radians(45.0f * i);
+        glm::mat4 ringTransform = glm::translate(glm::mat4(1.0f),
+                                                 glm::vec3(0.8f * std::cos(angle), 0.8f * std::sin(angle), 0.0f));
+        staticBatch.add(vertices, triangleIndices, glm::scale(ringTransform, glm::vec3(0.15f)));
+    }
+    staticBatch.build();
 
     // ------------------ Texture generation --------------
     // create multiple textures (file path, textrureUnit) -> start unit id from 0 and increment upto 15 ig
-    Texture hexagonTexture1((getExecutableDir() + "/images/stoneimage.png").c_str(), 0);
-    Texture hexagonTexture2((getExecutableDir() + "/images/smileyface.png").c_str(), 1);
+    // streamed -> they decode on worker threads and show a grey
+    // placeholder until the upload lands, so the loop never stalls
+    Texture hexagonTexture1((getExecutableDir() + "/images/stoneimage.png").c_str(), 0, true);
+    Texture hexagonTexture2((getExecutableDir() + "/images/smileyface.png").c_str(), 1, true);
+
+    // keep texture memory under budget: least-recently-used textures drop
+    // to a low-res tail when we go over, and come back on use/prefetch
+    ResidencyManager::shared().setBudget(256ull * 1024 * 1024);
+
+    // the renderer collects submissions and draws them sorted by state.
+    // no camera yet, so the cull frustum is just the clip-space cube
+    Renderer renderer;
+    renderer.setFrustum(glm::mat4(1.0f));
+    renderer.setCameraPosition(glm::vec3(0.0f)); // LOD distances measure from here
+
+    // per-stage timing (prints every few seconds, CSV on exit)
+    Profiler profiler;
+    unsigned int frameNumber = 0;
+
+    // on-screen stats overlay (all text batches into one draw call)
+    DebugText debugText;
+
+    // transform hierarchy -- just the hexagon for now, but world matrices
+    // of nodes that don't move are cached and never recomputed
+    Scene scene;
+    int hexagonNode = scene.addNode();
+
+    // passes declare reads/writes and the graph schedules them: it culls
+    // passes nobody consumes, orders the rest to minimize FBO rebinds,
+    // and aliases transient attachment memory. two backbuffer passes is a
+    // small graph, but new passes now slot in declaratively
+    RenderGraph graph;
+
+    // simulation runs at a fixed 120 Hz regardless of GPU frame time;
+    // swap interval 0 presents each finished frame straight away, so
+    // input latency doesn't stack up behind vsync either
+    window.setSwapInterval(0);
+    FixedTimestep timestep(120.0);
+    float hexagonAngle = 0.0f;
+    float previousAngle = 0.0f;
 
-        
     // Render loop
     while (!window.windowShouldClose())
     {
+        profiler.beginFrame();
+
         // Input
-        window.processInput();
+        {
+            ProfileScope scope(profiler, "input");
+            window.processInput();
+        }
 
-        // Rendering commands
-        glClearColor(0.0f, 0.0f, 0.0f, 1.0f);
-        glClear(GL_COLOR_BUFFER_BIT);
+        // pick up any texture decodes that finished since last frame
+        hexagonTexture1.update();
+        hexagonTexture2.update();
 
-        // linking or using the shader program
-        shaderprog.initialize();
+        // edited shader files swap in once their background compile is done
+        if (frameNumber % 30 == 0)
+        {
+            shaderprog.checkForReload();
+        }
 
+        // one upload for everything shaders share this frame (no camera
+        // yet, so view/projection stay identity)
+        FrameData frameData = {};
+        frameData.view = glm::mat4(1.0f);
+        frameData.projection = glm::mat4(1.0f);
+        frameData.time = (float)glfwGetTime();
+        frameDataBlock.upload(&frameData, sizeof(frameData));
 
-        shaderprog.setInt("myTexture1", 0);
-        shaderprog.setInt("myTexture2", 1);
+        // advance the sim in fixed ticks (one radian per second, like the
+        // old glfwGetTime rotation, but now deterministic per tick)...
+        int ticks = timestep.beginFrame();
+        for (int tick = 0; tick < ticks; tick++)
+        {
+            previousAngle = hexagonAngle;
+            hexagonAngle += (float)timestep.dt();
+        }
 
+        // ...and render BETWEEN the last two ticks, so motion stays
+        // smooth even when tick rate and frame rate drift apart
+        float renderAngle = previousAngle + (hexagonAngle - previousAngle) * timestep.alpha();
         glm::mat4 trans = glm::mat4(1.0f);
-        trans = glm::rotate(trans, (float)glfwGetTime(), glm::vec3(0.0f, 0.0f, 1.0f));    
+        trans = glm::rotate(trans, renderAngle, glm::vec3(0.0f, 0.0f, 1.0f));
+        scene.setLocalTransform(hexagonNode, trans);
+
+        // queue the hexagon and let the renderer sort + draw everything
+        // (no more bind/draw/unbind churn per object)
+        renderer.submit(hexagonMesh, shaderprog, {&hexagonTexture1, &hexagonTexture2},
+                        scene.getWorldTransform(hexagonNode));
+
+        // rebuild the frame's pass list and let the graph run it. both
+        // passes target the backbuffer, so the scheduler keeps them on
+        // one FBO bind; an offscreen pass added here later gets ordered,
+        // culled and aliased without touching this code
+        graph.reset();
+
+        graph.addPass("scene", {}, {RenderGraph::BACKBUFFER}, [&] {
+            GLStateCache::shared().clearColor(0.0f, 0.0f, 0.0f, 1.0f);
+            glClear(GL_COLOR_BUFFER_BIT);
 
-        unsigned int transformLoc = glGetUniformLocation(shaderprog.ID, "transform");
-        glUniformMatrix4fv(transformLoc, 1, GL_FALSE, glm::value_ptr(trans));    
+            // linking or using the shader program
+            shaderprog.initialize();
 
+            shaderprog.setInt("myTexture1", 0);
+            shaderprog.setInt("myTexture2", 1);
 
-        // render the hexagon
-        hexagonTexture1.bind();
-        hexagonTexture2.bind();
-        hexagonMesh.bind_VAO();
+            // the whole static ring first, in one call (positions are
+            // pre-transformed, so the per-draw transform stays identity)
+            shaderprog.setBool("useInstancing", false);
+            shaderprog.setMat4("transform", glm::mat4(1.0f));
+            staticBatch.draw();
 
-        glDrawElements(GL_TRIANGLE_FAN, hexagonMesh.getIndexCount(), GL_UNSIGNED_INT, 0);
-        
-        // glDrawElements(GL_TRIANGLE_FAN, hexagonMesh.getIndexCount(), GL_UNSIGNED_INT, 0); -> for drawing the hexagon in efficient way
-        hexagonMesh.unbind_VAO();
-        hexagonTexture1.unbind();
-        hexagonTexture2.unbind();
+            ProfileScope scope(profiler, "flush");
+            profiler.beginGpu("flush");
+            renderer.flush();
+            profiler.endGpu();
+        });
 
+        // stats overlay on top of the frame (numbers are one frame old,
+        // since this frame's timings aren't closed out yet)
+        graph.addPass("overlay", {}, {RenderGraph::BACKBUFFER}, [&] {
+            ProfileScope scope(profiler, "text");
+            char stats[128];
+            std::snprintf(stats, sizeof(stats),
+                          "frame %5.2f ms  gpu %5.2f ms\ndraws %u / %u submitted  arena %u kb",
+                          profiler.lastMs("frame"), profiler.lastMs("flush (gpu)"),
+                          renderer.getLastDrawCallCount(), renderer.getLastCommandCount(),
+                          (unsigned int)(FrameArena::threadLocal().getHighWaterMark() / 1024));
+            debugText.addText(8.0f, 8.0f, stats);
+            debugText.flush(window.getWidth(), window.getHeight());
+        });
+
+        graph.execute();
 
         // Swap buffers and poll events
-        window.swapBuffers();
+        {
+            ProfileScope scope(profiler, "swap");
+            window.swapBuffers();
+        }
         window.pollEvents();
+
+        profiler.endFrame();
+
+        // state-cache scoreboard: how many binds the shadow swallowed vs
+        // actually reached the driver (summary prints them as counts)
+        profiler.recordSample("gl calls elided", (float)GLStateCache::shared().getElidedCalls());
+        profiler.recordSample("gl calls issued", (float)GLStateCache::shared().getIssuedCalls());
+        GLStateCache::shared().resetCounters();
+
+        // LRU housekeeping: finish pending promotions, evict over budget
+        ResidencyManager::shared().endFrame();
+
+        // every per-frame arena allocation dies here, in one shot
+        FrameArena::threadLocal().reset();
+
+        frameNumber++;
+        if (frameNumber % 300 == 0)
+        {
+            profiler.printSummary();
+        }
     }
 
+    profiler.writeCSV(getExecutableDir() + "/profile.csv");
+
 
 
     glm::vec4 vec(1.0f, 0.0f, 0.0f, 1.0f);
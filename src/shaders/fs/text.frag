@@ -0,0 +1,17 @@
+#version 460 core
+
+out vec4 FragColor;
+
+in vec2 TexCoord;
+
+uniform sampler2D fontAtlas;
+uniform vec3 textColor;
+
+void main()
+{
+    // the atlas stores 1-bit coverage in the red channel; discarding the
+    // empty texels needs no blend state and lets the scene show through
+    if (texture(fontAtlas, TexCoord).r < 0.5)
+        discard;
+    FragColor = vec4(textColor, 1.0);
+}
@@ -0,0 +1,16 @@
+#version 460 core
+layout(location = 0) in vec2 aPos;      // pixels, origin at the top-left
+layout(location = 2) in vec2 aTexCoord; // font atlas uv (TexCoord2f's fixed slot)
+
+uniform vec2 screenSize;
+
+out vec2 TexCoord;
+
+void main()
+{
+    // pixel coordinates -> NDC, flipping y so (0, 0) is the top-left corner
+    vec2 ndc = vec2(aPos.x / screenSize.x * 2.0 - 1.0,
+                    1.0 - aPos.y / screenSize.y * 2.0);
+    gl_Position = vec4(ndc, 0.0, 1.0);
+    TexCoord = aTexCoord;
+}
@@ -3,7 +3,22 @@ layout(location = 0) in vec3 aPos;// position has attribute position 0
 layout(location = 1) in vec3 aColor; // color has attribute position 1
 layout(location = 2) in vec2 aTexCoord; // texture coordinates has attribute position 2
 
+// per-instance data (only fed when the mesh has an instance buffer;
+// the engine flips useInstancing to match)
+layout(location = 3) in mat4 aInstanceTransform; // takes slots 3,4,5,6
+layout(location = 7) in vec4 aInstanceColor;
+
+// shared per-frame globals, uploaded once per frame into one UBO
+// (binding point is assigned by the engine via bindUniformBlock)
+layout(std140) uniform FrameData
+{
+    mat4 view;
+    mat4 projection;
+    float time;
+};
+
 uniform mat4 transform;
+uniform bool useInstancing;
 
 out vec3 myColor;
 out vec2 TexCoord;
@@ -11,7 +26,10 @@ out vec2 TexCoord;
 
 void main()
 {
-    gl_Position = transform * vec4(aPos, 1.0f);  // we give a vec3 to vec4’s constructor
-    myColor = aColor;                            //output variable to dark-red
+    mat4 model = useInstancing ? aInstanceTransform : transform;
+    vec3 tint = useInstancing ? aInstanceColor.rgb : vec3(1.0);
+
+    gl_Position = projection * view * model * vec4(aPos, 1.0f);  // we give a vec3 to vec4’s constructor
+    myColor = aColor * tint;                     //output variable to dark-red
     TexCoord = aTexCoord;
-}
\ No newline at end of file
+}